@@ -66,4 +66,5 @@ void CheckThread::run()
 void CheckThread::stop()
 {
     mState = Stopping;
+    mCppcheck.terminate();
 }
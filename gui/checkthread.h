@@ -52,6 +52,11 @@ public:
     */
     void run();
 
+    /**
+    * @brief stop the checking
+    * The file that is being checked is stopped between its checking phases,
+    * see CppCheck::terminate().
+    */
     void stop();
 
 
@@ -76,7 +81,7 @@ protected:
     enum State
     {
         Running, /**< The thread is checking. */
-        Stopping, /**< The thread will stop after current work. */
+        Stopping, /**< The thread will stop as soon as the check notices it. */
         Stopped, /**< The thread has been stopped. */
         Ready, /**< The thread is ready. */
     };
@@ -48,7 +48,8 @@ void CsvReport::WriteHeader()
 
 void CsvReport::WriteFooter()
 {
-    // No footer for CSV report
+    // No footer for CSV report, just write out the buffered lines
+    mTxtWriter.flush();
 }
 
 void CsvReport::WriteError(const QStringList &files, const QStringList &lines,
@@ -65,5 +66,5 @@ void CsvReport::WriteError(const QStringList &files, const QStringList &lines,
     line += QString("%1,%2,").arg(files[files.size() - 1]).arg(lines[lines.size() - 1]);
     line += QString("%1,%2").arg(severity).arg(msg);
 
-    mTxtWriter << line << endl;
+    mTxtWriter << line << "\n";
 }
@@ -0,0 +1,75 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2009 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef ERRORITEM_H
+#define ERRORITEM_H
+
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+
+/// @addtogroup GUI
+/// @{
+
+/**
+* @brief An error found by cppcheck, as it is passed from the checking
+* threads to the results view
+*
+*/
+class ErrorItem
+{
+public:
+    /**
+    * @brief Filename
+    *
+    */
+    QString file;
+
+    /**
+    * @brief Error severity
+    *
+    */
+    QString severity;
+
+    /**
+    * @brief Error message
+    *
+    */
+    QString message;
+
+    /**
+    * @brief List of files affected by the error
+    *
+    */
+    QStringList files;
+
+    /**
+    * @brief List of file line numbers affected by the error
+    *
+    */
+    QVariantList lines;
+
+    /**
+    * @brief Error id
+    *
+    */
+    QString id;
+};
+
+/// @}
+#endif // ERRORITEM_H
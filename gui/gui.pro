@@ -34,8 +34,10 @@ HEADERS += 	mainwindow.h \
 		checkthread.h \
 		resultsview.h \
 		resultstree.h \
+		resultsmodel.h \
 		settingsdialog.h \
 		threadresult.h \
+		erroritem.h \
 		threadhandler.h \
 		applicationlist.h \
 		applicationdialog.h \
@@ -67,7 +69,13 @@ HEADERS += 	mainwindow.h \
 		../src/checkother.h \
 		../src/cppcheckexecutor.h \
 		../src/filelister.h \
-		../src/token.h 
+		../src/token.h \
+		../src/filereader.h \
+		../src/daemon.h \
+		../src/filecache.h \
+		../src/compiledatabase.h \
+		../src/errorqueue.h \
+		../src/tokenmatcher.h 
 
 
 SOURCES += 	main.cpp \
@@ -75,6 +83,7 @@ SOURCES += 	main.cpp \
 		checkthread.cpp \
 		resultsview.cpp \
 		resultstree.cpp \
+		resultsmodel.cpp \
 		threadresult.cpp \
 		threadhandler.cpp \
 		settingsdialog.cpp \
@@ -106,7 +115,12 @@ SOURCES += 	main.cpp \
 		../src/cppcheckexecutor.cpp \
 		../src/checkunusedfunctions.cpp \
 		../src/settings.cpp \
-		../src/tokenize.cpp
+		../src/tokenize.cpp \
+		../src/daemon.cpp \
+		../src/filecache.cpp \
+		../src/compiledatabase.cpp \
+		../src/errorqueue.cpp \
+		../src/tokenmatcher.cpp
 
 
 win32 {
@@ -0,0 +1,580 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2009 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#include <QApplication>
+#include <QDir>
+#include <algorithm>
+#include "resultsmodel.h"
+
+/**
+* @brief The internal id of a backtrace row has this bit set, the
+* other bits are the index of its error in mErrors + 1. The internal id of
+* an error row is the index of its file in mFiles + 1, and the internal
+* id of a file row is 0.
+*
+*/
+static const quint32 BACKTRACE = 0x80000000;
+
+/**
+* @brief The columns are File, Severity, Line and Message
+*
+*/
+static const int COLUMN_COUNT = 4;
+
+ResultsModel::ResultsModel(QObject *parent) :
+        QAbstractItemModel(parent),
+        mSortColumn(-1),
+        mSortOrder(Qt::AscendingOrder),
+        mShowFullPath(false),
+        mFileIcon(":images/text-x-generic.png"),
+        mBacktraceIcon(":images/go-down.png")
+{
+    for (int i = 0; i <= SHOW_NONE; i++)
+    {
+        mShowTypes[i] = true;
+    }
+
+    mSeverityIcons[SHOW_ALL] = QIcon(":images/dialog-warning.png");
+    mSeverityIcons[SHOW_ERRORS] = QIcon(":images/dialog-error.png");
+    mSeverityIcons[SHOW_STYLE] = QIcon(":images/dialog-information.png");
+    mSeverityIcons[SHOW_ALL_STYLE] = QIcon(":images/dialog-information.png");
+}
+
+ResultsModel::~ResultsModel()
+{
+}
+
+QModelIndex ResultsModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (!hasIndex(row, column, parent))
+    {
+        return QModelIndex();
+    }
+
+    if (!parent.isValid())
+    {
+        return createIndex(row, column, static_cast<quint32>(0));
+    }
+
+    int location = 0;
+    const int errorIndex = GetErrorIndex(parent, location);
+    if (errorIndex < 0)
+    {
+        //An error row under a file
+        return createIndex(row, column, static_cast<quint32>(mVisibleFiles[parent.row()] + 1));
+    }
+
+    //A backtrace row under an error
+    return createIndex(row, column, static_cast<quint32>(errorIndex + 1) | BACKTRACE);
+}
+
+QModelIndex ResultsModel::parent(const QModelIndex &index) const
+{
+    if (!index.isValid())
+    {
+        return QModelIndex();
+    }
+
+    const quint32 id = static_cast<quint32>(index.internalId());
+    if (id == 0)
+    {
+        return QModelIndex();
+    }
+
+    if (!(id & BACKTRACE))
+    {
+        return createIndex(mFiles[id - 1].row, 0, static_cast<quint32>(0));
+    }
+
+    const Error &error = mErrors[(id & ~BACKTRACE) - 1];
+    return createIndex(error.row, 0, static_cast<quint32>(error.file + 1));
+}
+
+int ResultsModel::rowCount(const QModelIndex &parent) const
+{
+    if (!parent.isValid())
+    {
+        return mVisibleFiles.size();
+    }
+
+    if (parent.column() != 0)
+    {
+        return 0;
+    }
+
+    int location = 0;
+    const Error *error = GetError(parent, location);
+    if (!error)
+    {
+        return mFiles[mVisibleFiles[parent.row()]].visible.size();
+    }
+
+    if (location > 0)
+    {
+        return 0;
+    }
+
+    //The backtrace files are the files after the first one
+    return qMax(0, qMin(error->item.files.size(), error->item.lines.size()) - 1);
+}
+
+int ResultsModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return COLUMN_COUNT;
+}
+
+QVariant ResultsModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+    {
+        return QVariant();
+    }
+
+    int location = 0;
+    const Error *error = GetError(index, location);
+
+    if (role == Qt::DisplayRole)
+    {
+        if (!error)
+        {
+            if (index.column() != 0)
+            {
+                return QVariant();
+            }
+
+            QString name = StripPath(mFiles[mVisibleFiles[index.row()]].path);
+            if (name.isEmpty())
+            {
+                name = QApplication::translate("ResultsTree", "Undefined file");
+            }
+            return name;
+        }
+
+        switch (index.column())
+        {
+        case 0:
+        {
+            QString name = StripPath(error->item.files.value(location));
+            if (name.isEmpty() && location == 0)
+            {
+                name = QApplication::translate("ResultsTree", "Undefined file");
+            }
+            return name;
+        }
+
+        case 1:
+            return QApplication::translate("ResultsTree", error->item.severity.toLatin1());
+
+        case 2:
+            return QString("%1").arg(error->item.lines.value(location).toInt());
+
+        case 3:
+            //TODO message has parameter names so we'll need changes to the core
+            //cppcheck so we can get proper translations
+            return QApplication::translate("ResultsTree", error->item.message.toLatin1());
+        }
+    }
+    else if (role == Qt::DecorationRole && index.column() == 0)
+    {
+        if (!error)
+        {
+            return mFileIcon;
+        }
+
+        if (location > 0)
+        {
+            return mBacktraceIcon;
+        }
+
+        return mSeverityIcons[error->type];
+    }
+
+    return QVariant();
+}
+
+QVariant ResultsModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+    {
+        return QVariant();
+    }
+
+    switch (section)
+    {
+    case 0:
+        return QApplication::translate("ResultsTree", "File");
+    case 1:
+        return QApplication::translate("ResultsTree", "Severity");
+    case 2:
+        return QApplication::translate("ResultsTree", "Line");
+    case 3:
+        return QApplication::translate("ResultsTree", "Message");
+    }
+
+    return QVariant();
+}
+
+Qt::ItemFlags ResultsModel::flags(const QModelIndex &index) const
+{
+    if (!index.isValid())
+    {
+        return 0;
+    }
+
+    return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+}
+
+void ResultsModel::sort(int column, Qt::SortOrder order)
+{
+    mSortColumn = column;
+    mSortOrder = order;
+    UpdateRows();
+}
+
+void ResultsModel::AddErrors(const QList<ErrorItem> &errors)
+{
+    for (int i = 0; i < errors.size(); i++)
+    {
+        const ErrorItem &item = errors[i];
+        if (item.files.isEmpty())
+        {
+            continue;
+        }
+
+        //Find the file of the error, or add it if this is its first error
+        int fileIndex = mFileIndexes.value(item.files[0], -1);
+        if (fileIndex < 0)
+        {
+            File file;
+            file.path = item.files[0];
+            file.row = -1;
+            mFiles << file;
+            fileIndex = mFiles.size() - 1;
+            mFileIndexes.insert(file.path, fileIndex);
+        }
+
+        Error error;
+        error.item = item;
+        error.type = SeverityToShowType(item.severity);
+        error.file = fileIndex;
+        error.row = -1;
+        mErrors << error;
+
+        const int errorIndex = mErrors.size() - 1;
+        File &file = mFiles[fileIndex];
+        file.errors << errorIndex;
+
+        if (!IsShown(error.type))
+        {
+            continue;
+        }
+
+        //The file gets a row with its first visible error
+        if (file.row < 0)
+        {
+            beginInsertRows(QModelIndex(), mVisibleFiles.size(), mVisibleFiles.size());
+            file.row = mVisibleFiles.size();
+            mVisibleFiles << fileIndex;
+        }
+        else
+        {
+            beginInsertRows(createIndex(file.row, 0, static_cast<quint32>(0)), file.visible.size(), file.visible.size());
+        }
+
+        mErrors[errorIndex].row = file.visible.size();
+        file.visible << errorIndex;
+        endInsertRows();
+    }
+}
+
+void ResultsModel::Clear()
+{
+    mErrors.clear();
+    mFiles.clear();
+    mFileIndexes.clear();
+    mVisibleFiles.clear();
+    reset();
+}
+
+void ResultsModel::ShowResults(ShowTypes type, bool show)
+{
+    if (type != SHOW_NONE && mShowTypes[type] != show)
+    {
+        mShowTypes[type] = show;
+        UpdateRows();
+    }
+}
+
+bool ResultsModel::HasVisibleResults() const
+{
+    return !mVisibleFiles.isEmpty();
+}
+
+bool ResultsModel::HasResults() const
+{
+    return !mErrors.isEmpty();
+}
+
+void ResultsModel::SetPaths(bool showFullPath, const QString &checkPath)
+{
+    if (mShowFullPath != showFullPath || mCheckPath != checkPath)
+    {
+        mShowFullPath = showFullPath;
+        mCheckPath = checkPath;
+        UpdateRows();
+    }
+}
+
+void ResultsModel::Translate()
+{
+    emit headerDataChanged(Qt::Horizontal, 0, COLUMN_COUNT - 1);
+    //TODO go through all the errors in the tree and translate severity and message
+}
+
+const ErrorItem *ResultsModel::GetError(const QModelIndex &index) const
+{
+    int location = 0;
+    const Error *error = GetError(index, location);
+    return error ? &error->item : 0;
+}
+
+QString ResultsModel::GetFile(const QModelIndex &index) const
+{
+    int location = 0;
+    const Error *error = GetError(index, location);
+    if (error)
+    {
+        return error->item.files.value(location);
+    }
+
+    if (index.isValid())
+    {
+        return mFiles[mVisibleFiles[index.row()]].path;
+    }
+
+    return QString();
+}
+
+QList<const ErrorItem *> ResultsModel::GetErrors(bool all) const
+{
+    QList<const ErrorItem *> errors;
+    for (int i = 0; i < mVisibleFiles.size(); i++)
+    {
+        const File &file = mFiles[mVisibleFiles[i]];
+        const QVector<int> &fileErrors = all ? file.errors : file.visible;
+        for (int j = 0; j < fileErrors.size(); j++)
+        {
+            errors << &mErrors[fileErrors[j]].item;
+        }
+    }
+    return errors;
+}
+
+ShowTypes ResultsModel::SeverityToShowType(const QString & severity)
+{
+    if (severity == "possible error")
+        return SHOW_ALL;
+    if (severity == "error")
+        return SHOW_ERRORS;
+    if (severity == "style")
+        return SHOW_STYLE;
+    if (severity == "possible style")
+        return SHOW_ALL_STYLE;
+
+    return SHOW_NONE;
+}
+
+ResultsModel::ErrorLessThan::ErrorLessThan(const ResultsModel *model, int column) :
+        mModel(model),
+        mColumn(column)
+{
+}
+
+bool ResultsModel::ErrorLessThan::operator()(int error1, int error2) const
+{
+    const ErrorItem &item1 = mModel->mErrors[error1].item;
+    const ErrorItem &item2 = mModel->mErrors[error2].item;
+
+    switch (mColumn)
+    {
+    case 1:
+        return item1.severity < item2.severity;
+    case 3:
+        return item1.message < item2.message;
+    }
+
+    //The errors of a file are in the same file => sort by the line
+    return item1.lines.value(0).toInt() < item2.lines.value(0).toInt();
+}
+
+ResultsModel::FileLessThan::FileLessThan(const ResultsModel *model) :
+        mModel(model)
+{
+}
+
+bool ResultsModel::FileLessThan::operator()(int file1, int file2) const
+{
+    return mModel->mFiles[file1].path < mModel->mFiles[file2].path;
+}
+
+void ResultsModel::UpdateRows()
+{
+    emit layoutAboutToBeChanged();
+
+    //Remember the errors and the files that the views point to, e.g.
+    //the expanded and the selected rows
+    const QModelIndexList from = persistentIndexList();
+    QVector<int> fromErrors(from.size(), -1);
+    QVector<int> fromLocations(from.size(), 0);
+    QVector<int> fromFiles(from.size(), -1);
+    for (int i = 0; i < from.size(); i++)
+    {
+        fromErrors[i] = GetErrorIndex(from[i], fromLocations[i]);
+        if (fromErrors[i] < 0 && from[i].isValid())
+        {
+            fromFiles[i] = mVisibleFiles[from[i].row()];
+        }
+    }
+
+    //Which errors are shown..
+    mVisibleFiles.clear();
+    for (int i = 0; i < mFiles.size(); i++)
+    {
+        File &file = mFiles[i];
+        file.row = -1;
+        file.visible.clear();
+        for (int j = 0; j < file.errors.size(); j++)
+        {
+            mErrors[file.errors[j]].row = -1;
+            if (IsShown(mErrors[file.errors[j]].type))
+            {
+                file.visible << file.errors[j];
+            }
+        }
+
+        if (!file.visible.isEmpty())
+        {
+            mVisibleFiles << i;
+        }
+    }
+
+    //..and in which order
+    if (mSortColumn >= 0)
+    {
+        qStableSort(mVisibleFiles.begin(), mVisibleFiles.end(), FileLessThan(this));
+        if (mSortOrder == Qt::DescendingOrder)
+        {
+            std::reverse(mVisibleFiles.begin(), mVisibleFiles.end());
+        }
+
+        for (int i = 0; i < mVisibleFiles.size(); i++)
+        {
+            File &file = mFiles[mVisibleFiles[i]];
+            qStableSort(file.visible.begin(), file.visible.end(), ErrorLessThan(this, mSortColumn));
+            if (mSortOrder == Qt::DescendingOrder)
+            {
+                std::reverse(file.visible.begin(), file.visible.end());
+            }
+        }
+    }
+
+    for (int i = 0; i < mVisibleFiles.size(); i++)
+    {
+        File &file = mFiles[mVisibleFiles[i]];
+        file.row = i;
+        for (int j = 0; j < file.visible.size(); j++)
+        {
+            mErrors[file.visible[j]].row = j;
+        }
+    }
+
+    //Move the persistent indexes to the new rows. The rows that are
+    //hidden now get invalid indexes.
+    QModelIndexList to;
+    for (int i = 0; i < from.size(); i++)
+    {
+        const int column = from[i].column();
+        if (fromErrors[i] >= 0)
+        {
+            const Error &error = mErrors[fromErrors[i]];
+            if (error.row < 0)
+                to << QModelIndex();
+            else if (fromLocations[i] == 0)
+                to << createIndex(error.row, column, static_cast<quint32>(error.file + 1));
+            else
+                to << createIndex(fromLocations[i] - 1, column, static_cast<quint32>(fromErrors[i] + 1) | BACKTRACE);
+        }
+        else if (fromFiles[i] >= 0 && mFiles[fromFiles[i]].row >= 0)
+        {
+            to << createIndex(mFiles[fromFiles[i]].row, column, static_cast<quint32>(0));
+        }
+        else
+        {
+            to << QModelIndex();
+        }
+    }
+    changePersistentIndexList(from, to);
+
+    emit layoutChanged();
+}
+
+bool ResultsModel::IsShown(ShowTypes type) const
+{
+    return mShowTypes[type];
+}
+
+int ResultsModel::GetErrorIndex(const QModelIndex &index, int &location) const
+{
+    if (!index.isValid())
+    {
+        return -1;
+    }
+
+    const quint32 id = static_cast<quint32>(index.internalId());
+    if (id == 0)
+    {
+        return -1;
+    }
+
+    if (!(id & BACKTRACE))
+    {
+        location = 0;
+        return mFiles[id - 1].visible[index.row()];
+    }
+
+    location = index.row() + 1;
+    return static_cast<int>(id & ~BACKTRACE) - 1;
+}
+
+const ResultsModel::Error *ResultsModel::GetError(const QModelIndex &index, int &location) const
+{
+    const int errorIndex = GetErrorIndex(index, location);
+    return (errorIndex >= 0) ? &mErrors[errorIndex] : 0;
+}
+
+QString ResultsModel::StripPath(const QString &path) const
+{
+    if (mShowFullPath)
+    {
+        return QString(path);
+    }
+
+    QDir dir(mCheckPath);
+    return dir.relativeFilePath(path);
+}
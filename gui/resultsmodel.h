@@ -0,0 +1,338 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2009 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef RESULTSMODEL_H
+#define RESULTSMODEL_H
+
+#include <QAbstractItemModel>
+#include <QHash>
+#include <QIcon>
+#include <QList>
+#include <QVector>
+#include "common.h"
+#include "erroritem.h"
+
+/// @addtogroup GUI
+/// @{
+
+
+/**
+* @brief Model of the errors shown in ResultsTree
+*
+* The errors are kept in a flat list and the rows of the tree are created
+* only when the view asks for them. The top level rows are the files, the
+* children of a file are its errors and the children of an error are the
+* other files of its backtrace.
+*
+* The errors that are hidden by their severity are kept, but they don't
+* have rows. Showing or hiding a severity only recalculates which errors
+* have rows.
+*/
+class ResultsModel : public QAbstractItemModel
+{
+    Q_OBJECT
+public:
+    ResultsModel(QObject *parent = 0);
+    virtual ~ResultsModel();
+
+    /**
+    * @brief QAbstractItemModel methods
+    *
+    */
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const;
+    QModelIndex parent(const QModelIndex &index) const;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+    Qt::ItemFlags flags(const QModelIndex &index) const;
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder);
+
+    /**
+    * @brief Add new errors
+    *
+    * @param errors the errors
+    */
+    void AddErrors(const QList<ErrorItem> &errors);
+
+    /**
+    * @brief Remove all errors
+    *
+    */
+    void Clear();
+
+    /**
+    * @brief Show/hide certain type of errors
+    *
+    * @param type Type of error to show/hide
+    * @param show Should specified errors be shown (true) or hidden (false)
+    */
+    void ShowResults(ShowTypes type, bool show);
+
+    /**
+    * @brief Is there at least one visible error?
+    *
+    */
+    bool HasVisibleResults() const;
+
+    /**
+    * @brief Is there at least one error, hidden or visible?
+    *
+    */
+    bool HasResults() const;
+
+    /**
+    * @brief Show the full paths of the files (true) or paths relative to
+    * the checked directory (false)
+    *
+    * @param showFullPath show full paths?
+    * @param checkPath the checked directory
+    */
+    void SetPaths(bool showFullPath, const QString &checkPath);
+
+    /**
+    * @brief Tell the views that the translated texts have changed
+    *
+    */
+    void Translate();
+
+    /**
+    * @brief Get the error of an error row or a backtrace row
+    *
+    * @param index Model index of the row
+    * @return the error, or 0 if the row is a file row
+    */
+    const ErrorItem *GetError(const QModelIndex &index) const;
+
+    /**
+    * @brief Get the full path of the file shown in a row
+    *
+    * @param index Model index of the row
+    * @return the full path
+    */
+    QString GetFile(const QModelIndex &index) const;
+
+    /**
+    * @brief Get the errors of the files that are shown, in the order
+    * they are shown
+    *
+    * @param all Get also the hidden errors of the files
+    * @return the errors
+    */
+    QList<const ErrorItem *> GetErrors(bool all) const;
+
+    /**
+    * @brief Convert severity string to ShowTypes value
+    * @param severity Error severity string
+    * @return Severity converted to ShowTypes value
+    */
+    static ShowTypes SeverityToShowType(const QString &severity);
+
+protected:
+
+    /**
+    * @brief An error and the row where it is shown
+    *
+    */
+    class Error
+    {
+    public:
+        ErrorItem item;
+
+        /**
+        * @brief Severity of the error
+        *
+        */
+        ShowTypes type;
+
+        /**
+        * @brief Index of the file in mFiles
+        *
+        */
+        int file;
+
+        /**
+        * @brief Row of the error under its file, or -1 if it is hidden
+        *
+        */
+        int row;
+    };
+
+    /**
+    * @brief A file that has errors and the row where it is shown
+    *
+    */
+    class File
+    {
+    public:
+        /**
+        * @brief Full path of the file
+        *
+        */
+        QString path;
+
+        /**
+        * @brief Indexes of the errors of the file in mErrors
+        *
+        */
+        QVector<int> errors;
+
+        /**
+        * @brief Indexes of the visible errors in mErrors, in the order of
+        * the rows
+        *
+        */
+        QVector<int> visible;
+
+        /**
+        * @brief Row of the file, or -1 if it is hidden
+        *
+        */
+        int row;
+    };
+
+    /**
+    * @brief Compares the errors by a column, see sort()
+    *
+    */
+    class ErrorLessThan
+    {
+    public:
+        ErrorLessThan(const ResultsModel *model, int column);
+        bool operator()(int error1, int error2) const;
+    private:
+        const ResultsModel *mModel;
+        int mColumn;
+    };
+
+    /**
+    * @brief Compares the files by their paths, see sort()
+    *
+    */
+    class FileLessThan
+    {
+    public:
+        FileLessThan(const ResultsModel *model);
+        bool operator()(int file1, int file2) const;
+    private:
+        const ResultsModel *mModel;
+    };
+
+    /**
+    * @brief Calculate again which errors and files are shown and in which
+    * order. The views keep their selections and expanded rows.
+    *
+    */
+    void UpdateRows();
+
+    /**
+    * @brief Is an error with the given severity shown?
+    *
+    */
+    bool IsShown(ShowTypes type) const;
+
+    /**
+    * @brief Index of the error in the given row
+    *
+    * @param index Model index of an error row or a backtrace row
+    * @param location The index of the file in the backtrace is written here
+    * @return the index in mErrors, or -1 if the row is a file row
+    */
+    int GetErrorIndex(const QModelIndex &index, int &location) const;
+
+    /**
+    * @brief The error in the given row
+    *
+    * @param index Model index of an error row or a backtrace row
+    * @param location The index of the file in the backtrace is written here
+    * @return the error, or 0 if the row is a file row
+    */
+    const Error *GetError(const QModelIndex &index, int &location) const;
+
+    /**
+    * @brief Removes checking directory from given path if mShowFullPath is false
+    *
+    * @param path Path to remove checking directory
+    * @return Path that has checking directory removed
+    */
+    QString StripPath(const QString &path) const;
+
+    /**
+    * @brief All the errors
+    *
+    */
+    QList<Error> mErrors;
+
+    /**
+    * @brief All the files that have errors
+    *
+    */
+    QList<File> mFiles;
+
+    /**
+    * @brief Index of each file in mFiles. The key is the full path.
+    *
+    */
+    QHash<QString, int> mFileIndexes;
+
+    /**
+    * @brief Indexes of the visible files in mFiles, in the order of the rows
+    *
+    */
+    QVector<int> mVisibleFiles;
+
+    /**
+    * @brief Which of ShowTypes are shown (true) and which are hidden (false)
+    *
+    */
+    bool mShowTypes[SHOW_NONE + 1];
+
+    /**
+    * @brief The column that the rows are sorted by, or -1 if not sorted
+    *
+    */
+    int mSortColumn;
+
+    /**
+    * @brief The order of the sorted rows
+    *
+    */
+    Qt::SortOrder mSortOrder;
+
+    /**
+    * @brief Should full path of files be shown (true) or relative (false)
+    *
+    */
+    bool mShowFullPath;
+
+    /**
+    * @brief Path we are currently checking
+    *
+    */
+    QString mCheckPath;
+
+    /**
+    * @brief Icons of the rows
+    *
+    */
+    QIcon mFileIcon;
+    QIcon mBacktraceIcon;
+    QIcon mSeverityIcons[SHOW_NONE + 1];
+};
+/// @}
+#endif // RESULTSMODEL_H
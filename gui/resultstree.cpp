@@ -30,14 +30,10 @@
 
 ResultsTree::ResultsTree(QWidget * parent) :
         QTreeView(parent),
-        mContextItem(0),
-        mCheckPath(""),
-        mVisibleErrors(false)
+        mShowFullPath(false),
+        mCheckPath("")
 {
     setModel(&mModel);
-    QStringList labels;
-    labels << tr("File") << tr("Severity") << tr("Line") << tr("Message");
-    mModel.setHorizontalHeaderLabels(labels);
     setExpandsOnDoubleClick(false);
     setSortingEnabled(true);
 
@@ -57,157 +53,14 @@ void ResultsTree::Initialize(QSettings *settings, ApplicationList *list)
 }
 
 
-QStandardItem *ResultsTree::CreateItem(const QString &name)
+void ResultsTree::AddErrors(const QList<ErrorItem> &errors)
 {
-    QStandardItem *item = new QStandardItem(name);
-    item->setEditable(false);
-    return item;
-}
-
-void ResultsTree::AddErrorItem(const QString &file,
-                               const QString &severity,
-                               const QString &message,
-                               const QStringList &files,
-                               const QVariantList &lines,
-                               const QString &id)
-{
-    Q_UNUSED(file);
-
-    if (files.isEmpty())
-    {
-        return;
-    }
-
-    QString realfile = StripPath(files[0], false);
-
-    if (realfile.isEmpty())
-    {
-        realfile = tr("Undefined file");
-    }
-
-    bool hide = !mShowTypes[SeverityToShowType(severity)];
-
-    //if there is at least on error that is not hidden, we have a visible error
-    if (!hide)
-    {
-        mVisibleErrors = true;
-    }
-
-    //Create the base item for the error and ensure it has a proper
-    //file item as a parent
-    QStandardItem *item = AddBacktraceFiles(EnsureFileItem(files[0], hide),
-                                            realfile,
-                                            lines[0].toInt(),
-                                            severity,
-                                            message,
-                                            hide,
-                                            SeverityToIcon(severity));
-
-
-    //Add user data to that item
-    QMap<QString, QVariant> data;
-    data["severity"]  = SeverityToShowType(severity);
-    data["message"]  = message;
-    data["files"]  = files;
-    data["lines"]  = lines;
-    data["id"]  = id;
-    item->setData(QVariant(data));
-
-    //Add backtrace files as children
-    for (int i = 1; i < files.size() && i < lines.size(); i++)
-    {
-        AddBacktraceFiles(item,
-                          StripPath(files[i], false),
-                          lines[i].toInt(),
-                          severity,
-                          message,
-                          hide,
-                          ":images/go-down.png");
-    }
-
-    //TODO just hide/show current error and it's file
-    //since this does a lot of unnecessary work
-    if (!hide)
-    {
-        ShowFileItem(realfile);
-    }
-}
-
-QStandardItem *ResultsTree::AddBacktraceFiles(QStandardItem *parent,
-        const QString &file,
-        const int line,
-        const QString &severity,
-        const QString &message,
-        const bool hide,
-        const QString &icon)
-
-{
-    if (!parent)
-    {
-        return 0;
-    }
-
-    QList<QStandardItem*> list;
-    list << CreateItem(file);
-    list << CreateItem(tr(severity.toLatin1()));
-    list << CreateItem(QString("%1").arg(line));
-    //TODO message has parameter names so we'll need changes to the core
-    //cppcheck so we can get proper translations
-    list << CreateItem(tr(message.toLatin1()));
-
-    QModelIndex index = QModelIndex();
-
-    parent->appendRow(list);
-
-    setRowHidden(parent->rowCount() - 1, parent->index(), hide);
-
-    if (!icon.isEmpty())
-    {
-        list[0]->setIcon(QIcon(icon));
-    }
-
-    //TODO Does this leak memory? Should items from list be deleted?
-
-    return list[0];
-}
-
-ShowTypes ResultsTree::VariantToShowType(const QVariant &data)
-{
-    int value = data.toInt();
-    if (value < SHOW_ALL && value > SHOW_ERRORS)
-    {
-        return SHOW_NONE;
-    }
-    return (ShowTypes)value;
-}
-
-ShowTypes ResultsTree::SeverityToShowType(const QString & severity)
-{
-    if (severity == "possible error")
-        return SHOW_ALL;
-    if (severity == "error")
-        return SHOW_ERRORS;
-    if (severity == "style")
-        return SHOW_STYLE;
-    if (severity == "possible style")
-        return SHOW_ALL_STYLE;
-
-    return SHOW_NONE;
-}
-
-QStandardItem *ResultsTree::FindFileItem(const QString &name)
-{
-    QList<QStandardItem *> list = mModel.findItems(name);
-    if (list.size() > 0)
-    {
-        return list[0];
-    }
-    return 0;
+    mModel.AddErrors(errors);
 }
 
 void ResultsTree::Clear()
 {
-    mModel.removeRows(0, mModel.rowCount());
+    mModel.Clear();
 }
 
 void ResultsTree::LoadSettings()
@@ -222,6 +75,7 @@ void ResultsTree::LoadSettings()
     mSaveFullPath = mSettings->value(SETTINGS_SAVE_FULL_PATH, false).toBool();
     mSaveAllErrors = mSettings->value(SETTINGS_SAVE_ALL_ERRORS, false).toBool();
     mShowFullPath = mSettings->value(SETTINGS_SHOW_FULL_PATH, false).toBool();
+    mModel.SetPaths(mShowFullPath, mCheckPath);
 }
 
 void ResultsTree::SaveSettings()
@@ -235,103 +89,7 @@ void ResultsTree::SaveSettings()
 
 void ResultsTree::ShowResults(ShowTypes type, bool show)
 {
-    if (type != SHOW_NONE && mShowTypes[type] != show)
-    {
-        mShowTypes[type] = show;
-        RefreshTree();
-    }
-}
-
-
-void ResultsTree::RefreshTree()
-{
-    mVisibleErrors = false;
-    //Get the amount of files in the tree
-    int filecount = mModel.rowCount();
-
-    for (int i = 0; i < filecount; i++)
-    {
-        //Get file i
-        QStandardItem *file = mModel.item(i, 0);
-        if (!file)
-        {
-            continue;
-        }
-
-        //Get the amount of errors this file contains
-        int errorcount = file->rowCount();
-
-        //By default it shouldn't be visible
-        bool show = false;
-
-        for (int j = 0; j < errorcount; j++)
-        {
-            //Get the error itself
-            QStandardItem *child = file->child(j, 0);
-            if (!child)
-            {
-                continue;
-            }
-
-            //Get error's user data
-            QVariant userdata = child->data();
-            //Convert it to QVariantMap
-            QVariantMap data = userdata.toMap();
-
-            //Check if this error should be hidden
-            bool hide = !mShowTypes[VariantToShowType(data["severity"])];
-
-            if (!hide)
-            {
-                mVisibleErrors = true;
-            }
-
-            //Hide/show accordingly
-            setRowHidden(j, file->index(), hide);
-
-            //If it was shown then the file itself has to be shown aswell
-            if (!hide)
-            {
-                show = true;
-            }
-        }
-
-        //Show the file if any of it's errors are visible
-        setRowHidden(i, QModelIndex(), !show);
-    }
-}
-
-QStandardItem *ResultsTree::EnsureFileItem(const QString &fullpath, bool hide)
-{
-    QString name = StripPath(fullpath, false);
-    QStandardItem *item = FindFileItem(name);
-
-    if (item)
-    {
-        return item;
-    }
-
-    item = CreateItem(name);
-    item->setIcon(QIcon(":images/text-x-generic.png"));
-
-    //Add user data to that item
-    QMap<QString, QVariant> data;
-    data["files"] = fullpath;
-    item->setData(QVariant(data));
-    mModel.appendRow(item);
-
-    setRowHidden(mModel.rowCount() - 1, QModelIndex(), hide);
-
-    return item;
-}
-
-void ResultsTree::ShowFileItem(const QString &name)
-{
-    QStandardItem *item = FindFileItem(name);
-    if (item)
-    {
-        setRowHidden(0, mModel.indexFromItem(item), false);
-    }
+    mModel.ShowResults(type, show);
 }
 
 void ResultsTree::contextMenuEvent(QContextMenuEvent * e)
@@ -339,7 +97,10 @@ void ResultsTree::contextMenuEvent(QContextMenuEvent * e)
     QModelIndex index = indexAt(e->pos());
     if (index.isValid())
     {
-        mContextItem = mModel.itemFromIndex(index);
+        mContextItem = index;
+
+        //Applications can be started only for the errors
+        const bool errorItem = index.parent().isValid();
 
         //Create a new context menu
         QMenu menu(this);
@@ -351,7 +112,7 @@ void ResultsTree::contextMenuEvent(QContextMenuEvent * e)
         //member variables
         QSignalMapper *signalMapper = new QSignalMapper(this);
 
-        if (mContextItem && mApplications->GetApplicationCount() > 0 && mContextItem->parent())
+        if (mApplications->GetApplicationCount() > 0 && errorItem)
         {
             //Go through all applications and add them to the context menu
             for (int i = 0; i < mApplications->GetApplicationCount(); i++)
@@ -377,28 +138,25 @@ void ResultsTree::contextMenuEvent(QContextMenuEvent * e)
         }
 
         // Add menuitems to copy full path/filename to clipboard
-        if (mContextItem)
+        if (mApplications->GetApplicationCount() > 0)
         {
-            if (mApplications->GetApplicationCount() > 0)
-            {
-                menu.addSeparator();
-            }
+            menu.addSeparator();
+        }
 
-            //Create an action for the application
-            QAction *copyfilename = new QAction(tr("Copy filename"), &menu);
-            QAction *copypath = new QAction(tr("Copy full path"), &menu);
+        //Create an action for the application
+        QAction *copyfilename = new QAction(tr("Copy filename"), &menu);
+        QAction *copypath = new QAction(tr("Copy full path"), &menu);
 
-            menu.addAction(copyfilename);
-            menu.addAction(copypath);
+        menu.addAction(copyfilename);
+        menu.addAction(copypath);
 
-            connect(copyfilename, SIGNAL(triggered()), this, SLOT(CopyFilename()));
-            connect(copypath, SIGNAL(triggered()), this, SLOT(CopyFullPath()));
-        }
+        connect(copyfilename, SIGNAL(triggered()), this, SLOT(CopyFilename()));
+        connect(copypath, SIGNAL(triggered()), this, SLOT(CopyFullPath()));
 
         //Start the menu
         menu.exec(e->globalPos());
 
-        if (mContextItem && mApplications->GetApplicationCount() > 0 && mContextItem->parent())
+        if (mApplications->GetApplicationCount() > 0 && errorItem)
         {
             //Disconnect all signals
             for (int i = 0; i < actions.size(); i++)
@@ -416,7 +174,7 @@ void ResultsTree::contextMenuEvent(QContextMenuEvent * e)
     }
 }
 
-void ResultsTree::StartApplication(QStandardItem *target, int application)
+void ResultsTree::StartApplication(const QModelIndex &target, int application)
 {
     //If there are now application's specified, tell the user about it
     if (mApplications->GetApplicationCount() == 0)
@@ -430,17 +188,16 @@ void ResultsTree::StartApplication(QStandardItem *target, int application)
         return;
     }
 
-    if (target && application >= 0 && application < mApplications->GetApplicationCount() && target->parent())
+    const ErrorItem *error = mModel.GetError(target);
+    if (error && application >= 0 && application < mApplications->GetApplicationCount())
     {
-        QVariantMap data = target->data().toMap();
-
         QString program = mApplications->GetApplicationPath(application);
 
         //TODO Check which line was actually right clicked, now defaults to 0
         unsigned int index = 0;
 
         //Replace (file) with filename
-        QStringList files = data["files"].toStringList();
+        const QStringList &files = error->files;
         if (files.size() > 0)
         {
             program.replace("(file)", files[index], Qt::CaseInsensitive);
@@ -451,7 +208,7 @@ void ResultsTree::StartApplication(QStandardItem *target, int application)
         }
 
 
-        QVariantList lines = data["lines"].toList();
+        const QVariantList &lines = error->lines;
         if (lines.size() > 0)
         {
             program.replace("(line)", QString("%1").arg(lines[index].toInt()), Qt::CaseInsensitive);
@@ -461,8 +218,8 @@ void ResultsTree::StartApplication(QStandardItem *target, int application)
             qDebug("Failed to get filenumber!");
         }
 
-        program.replace("(message)", data["message"].toString(), Qt::CaseInsensitive);
-        program.replace("(severity)", data["severity"].toString(), Qt::CaseInsensitive);
+        program.replace("(message)", error->message, Qt::CaseInsensitive);
+        program.replace("(severity)", error->severity, Qt::CaseInsensitive);
 
         bool success = QProcess::startDetached(program);
         if (!success)
@@ -497,30 +254,18 @@ void ResultsTree::Context(int application)
 
 void ResultsTree::QuickStartApplication(const QModelIndex &index)
 {
-    StartApplication(mModel.itemFromIndex(index), 0);
+    StartApplication(index, 0);
 }
 
-void ResultsTree::CopyPath(QStandardItem *target, bool fullPath)
+void ResultsTree::CopyPath(const QModelIndex &target, bool fullPath)
 {
-    if (target)
+    if (target.isValid())
     {
-        QVariantMap data = target->data().toMap();
-        QString pathStr;
-
-        //Replace (file) with filename
-        QStringList files = data["files"].toStringList();
-        if (files.size() > 0)
+        QString pathStr = mModel.GetFile(target);
+        if (!fullPath)
         {
-            pathStr = files[0];
-            if (!fullPath)
-            {
-                QFileInfo fi(pathStr);
-                pathStr = fi.fileName();
-            }
-        }
-        else
-        {
-            qDebug("Failed to get filename!");
+            QFileInfo fi(pathStr);
+            pathStr = fi.fileName();
         }
 
         QClipboard *clipboard = QApplication::clipboard();
@@ -528,81 +273,38 @@ void ResultsTree::CopyPath(QStandardItem *target, bool fullPath)
     }
 }
 
-QString ResultsTree::SeverityToIcon(const QString &severity)
-{
-    if (severity == "possible error")
-        return ":images/dialog-warning.png";
-    if (severity == "error")
-        return ":images/dialog-error.png";
-    if (severity == "style" || severity == "possible style")
-        return ":images/dialog-information.png";
-
-    return "";
-}
-
 void ResultsTree::SaveResults(Report *report)
 {
     report->WriteHeader();
 
-    for (int i = 0; i < mModel.rowCount(); i++)
+    const QList<const ErrorItem *> errors = mModel.GetErrors(mSaveAllErrors);
+    for (int i = 0; i < errors.size(); i++)
     {
-        QStandardItem *item = mModel.item(i, 0);
-        if (!isRowHidden(i, item->index()))
-            SaveErrors(report, item);
+        SaveError(report, *errors[i]);
     }
 
     report->WriteFooter();
 }
 
-void ResultsTree::SaveErrors(Report *report, QStandardItem *item)
+void ResultsTree::SaveError(Report *report, const ErrorItem &error)
 {
-    if (!item)
+    QString severity = ShowTypeToString(ResultsModel::SeverityToShowType(error.severity));
+    QStringList files = error.files;
+    const QVariantList &lines = error.lines;
+
+    if (files.size() <= 0 || lines.size() <= 0 || lines.size() != files.size())
     {
         return;
     }
 
-    //qDebug() << item->text() << "has" << item->rowCount() << "errors";
-
-    for (int i = 0; i < item->rowCount(); i++)
-    {
-        QStandardItem *error = item->child(i, 0);
-
-        if (!error)
-        {
-            continue;
-        }
-
-        if (isRowHidden(i, item->index()) && !mSaveAllErrors)
-        {
-            continue;
-        }
-
-        //Get error's user data
-        QVariant userdata = error->data();
-        //Convert it to QVariantMap
-        QVariantMap data = userdata.toMap();
+    for (int i = 0; i < files.count(); i++)
+        files[i] = StripPath(files[i], true);
 
-        QString line;
-        QString severity = ShowTypeToString(VariantToShowType(data["severity"]));
-        QString message = data["message"].toString();
-        QString id = data["id"].toString();
-        QStringList files = data["files"].toStringList();
-        QVariantList lines = data["lines"].toList();
+    QStringList linesStr;
+    for (int i = 0; i < lines.count(); i++)
+        linesStr << lines[i].toString();
 
-        if (files.size() <= 0 || lines.size() <= 0 || lines.size() != files.size())
-        {
-            continue;
-        }
-
-        for (int i = 0; i < files.count(); i++)
-            files[i] = StripPath(files[i], true);
-
-        QStringList linesStr;
-        for (int i = 0; i < lines.count(); i++)
-            linesStr << lines[i].toString();
-
-        report->WriteError(files, linesStr, id, severity, message);
-    }
+    report->WriteError(files, linesStr, error.id, severity, error.message);
 }
 
 QString ResultsTree::ShowTypeToString(ShowTypes type)
@@ -640,7 +342,7 @@ void ResultsTree::UpdateSettings(bool showFullPath,
     if (mShowFullPath != showFullPath)
     {
         mShowFullPath = showFullPath;
-        RefreshFilePaths();
+        mModel.SetPaths(mShowFullPath, mCheckPath);
     }
 
     mSaveFullPath = saveFullPath;
@@ -650,6 +352,7 @@ void ResultsTree::UpdateSettings(bool showFullPath,
 void ResultsTree::SetCheckDirectory(const QString &dir)
 {
     mCheckPath = dir;
+    mModel.SetPaths(mShowFullPath, mCheckPath);
 }
 
 QString ResultsTree::StripPath(const QString &path, bool saving)
@@ -663,97 +366,18 @@ QString ResultsTree::StripPath(const QString &path, bool saving)
     return dir.relativeFilePath(path);
 }
 
-void ResultsTree::RefreshFilePaths(QStandardItem *item)
-{
-    if (!item)
-    {
-        return;
-    }
-
-    //Mark that this file's path hasn't been updated yet
-    bool updated = false;
-
-    //Loop through all errors within this file
-    for (int i = 0; i < item->rowCount(); i++)
-    {
-        //Get error i
-        QStandardItem *error = item->child(i, 0);
-
-        if (!error)
-        {
-            continue;
-        }
-
-        //Get error's user data
-        QVariant userdata = error->data();
-        //Convert it to QVariantMap
-        QVariantMap data = userdata.toMap();
-
-        //Get list of files
-        QStringList files = data["files"].toStringList();
-
-        //We should always have at least 1 file per error
-        if (files.size() == 0)
-        {
-            continue;
-        }
-
-        //Update this error's text
-        error->setText(StripPath(files[0], false));
-
-        //If this error has backtraces make sure the files list has enough filenames
-        if (error->rowCount() <= files.size() - 1)
-        {
-            //Loop through all files within the error
-            for (int j = 0; j < error->rowCount(); j++)
-            {
-                //Get file
-                QStandardItem *file = error->child(j, 0);
-                if (!file)
-                {
-                    continue;
-                }
-                //Update file's path
-                file->setText(StripPath(files[j+1], false));
-            }
-        }
-
-        //if the main file hasn't been updated yet, update it now
-        if (!updated)
-        {
-            updated = true;
-            item->setText(error->text());
-        }
-
-    }
-}
-
-void ResultsTree::RefreshFilePaths()
-{
-    qDebug("Refreshing file paths");
-
-    //Go through all file items (these are parent items that contain the errors)
-    for (int i = 0; i < mModel.rowCount(); i++)
-    {
-        RefreshFilePaths(mModel.item(i, 0));
-    }
-}
-
 bool ResultsTree::HasVisibleResults() const
 {
-    return mVisibleErrors;
+    return mModel.HasVisibleResults();
 }
 
 bool ResultsTree::HasResults() const
 {
-    return mModel.rowCount() > 0;
+    return mModel.HasResults();
 }
 
 void ResultsTree::Translate()
 {
-    QStringList labels;
-    labels << tr("File") << tr("Severity") << tr("Line") << tr("Message");
-    mModel.setHorizontalHeaderLabels(labels);
-    //TODO go through all the errors in the tree and translate severity and message
+    mModel.Translate();
 }
 
@@ -21,12 +21,13 @@
 #define RESULTSTREE_H
 
 #include <QTreeView>
-#include <QStandardItemModel>
-#include <QStandardItem>
+#include <QPersistentModelIndex>
 #include <QSettings>
 #include <QContextMenuEvent>
 #include "common.h"
 #include "applicationlist.h"
+#include "erroritem.h"
+#include "resultsmodel.h"
 #include <QTextStream>
 
 class Report;
@@ -48,20 +49,11 @@ public:
     void Initialize(QSettings *settings, ApplicationList *list);
 
     /**
-    * @brief Add a new item to the tree
+    * @brief Add new errors to the tree
     *
-    * @param file filename
-    * @param severity error severity
-    * @param message error message
-    * @param files list of files affected by the error
-    * @param lines list of file line numers affected by the error
+    * @param errors the errors
     */
-    void AddErrorItem(const QString &file,
-                      const QString &severity,
-                      const QString &message,
-                      const QStringList &files,
-                      const QVariantList &lines,
-                      const QString &id);
+    void AddErrors(const QList<ErrorItem> &errors);
 
     /**
     * @brief Clear all errors from the tree
@@ -71,7 +63,6 @@ public:
 
     /**
     * @brief Function to show/hide certain type of errors
-    * Refreshes the tree.
     *
     * @param type Type of error to show/hide
     * @param show Should specified errors be shown (true) or hidden (false)
@@ -153,19 +144,6 @@ protected slots:
 
 protected:
 
-    /**
-    * @brief Hides/shows full file path on all error file items according to mShowFullPath
-    *
-    */
-    void RefreshFilePaths();
-
-    /**
-    * @brief Hides/shows full file path on all error file items according to mShowFullPath
-    * @param item Parent item whose childrens paths to change
-    */
-    void RefreshFilePaths(QStandardItem *item);
-
-
     /**
     * @brief Removes checking directory from given path if mShowFullPath is false
     *
@@ -177,18 +155,12 @@ protected:
 
 
     /**
-    * @brief Save all errors under spesified item
+    * @brief Save an error
     *
-    * @param item Item whose errors to save
+    * @param report Report to write the error to
+    * @param error Error to save
     */
-    void SaveErrors(Report *report, QStandardItem *item);
-
-    /**
-    * @brief Convert a severity string to a icon filename
-    *
-    * @param severity Severity string
-    */
-    QString SeverityToIcon(const QString &severity);
+    void SaveError(Report *report, const ErrorItem &error);
 
     /**
     * @brief Helper function to open an error within target with application*
@@ -196,7 +168,7 @@ protected:
     * @param target Error tree item to open
     * @param application Index of the application to open with
     */
-    void StartApplication(QStandardItem *target, int application);
+    void StartApplication(const QModelIndex &target, int application);
 
     /**
     * @brief Helper function to copy filename/full path to the clipboard
@@ -204,7 +176,7 @@ protected:
     * @param target Error tree item to open
     * @param fullPath Are we copying full path or only filename?
     */
-    void CopyPath(QStandardItem *target, bool fullPath);
+    void CopyPath(const QModelIndex &target, bool fullPath);
 
     /**
     * @brief Context menu event (user right clicked on the tree)
@@ -213,49 +185,6 @@ protected:
     */
     void contextMenuEvent(QContextMenuEvent * e);
 
-    /**
-    * @brief Add a new error item beneath a file or a backtrace item beneath an error
-    *
-    * @param parent Parent for the item. Either a file item or an error item
-    * @param file Filename of the error
-    * @param line Line numer
-    * @param severity Error severity
-    * @param message Error message
-    * @param hide Should this be hidden (true) or shown (false)
-    * @param icon Should a default backtrace item icon be added
-    * @return newly created QStandardItem *
-    */
-    QStandardItem *AddBacktraceFiles(QStandardItem *parent,
-                                     const QString &file,
-                                     const int line,
-                                     const QString &severity,
-                                     const QString &message,
-                                     const bool hide,
-                                     const QString &icon);
-
-
-    /**
-    * @brief Refresh tree by checking which of the items should be shown
-    * and which should be hidden
-    *
-    */
-    void RefreshTree();
-
-    /**
-    * @brief Convert QVariant (that contains an int) to Showtypes value
-    *
-    * @param data QVariant (that contains an int) to be converted
-    * @return data converted to ShowTypes
-    */
-    ShowTypes VariantToShowType(const QVariant &data);
-
-    /**
-    * @brief Convert severity string to ShowTypes value
-    * @param severity Error severity string
-    * @return Severity converted to ShowTypes value
-    */
-    ShowTypes SeverityToShowType(const QString &severity);
-
     /**
     * @brief Convert ShowType to severity string
     * @param type ShowType to convert
@@ -269,45 +198,11 @@ protected:
     */
     void LoadSettings();
 
-
-    /**
-    * @brief Create a new QStandardItem
-    *
-    * @param name name for the item
-    * @return new QStandardItem
-    */
-    QStandardItem *CreateItem(const QString &name);
-
-    /**
-    * @brief Finds a file item
-    *
-    * @param name name of the file item to find
-    * @return pointer to file item or null if none found
-    */
-    QStandardItem *FindFileItem(const QString &name);
-
-
-    /**
-    * @brief Ensures there's a item in the model for the specified file
-    *
-    * @param fullpath Full path to the file item.
-    * @param hide is the error (we want this file item for) hidden?
-    * @return QStandardItem to be used as a parent for all errors for specified file
-    */
-    QStandardItem *EnsureFileItem(const QString &fullpath, bool hide);
-
-    /**
-    * @brief Show a file item
-    *
-    * @param name Filename of the fileitem
-    */
-    void ShowFileItem(const QString &name);
-
     /**
     * @brief Item model for tree
     *
     */
-    QStandardItemModel mModel;
+    ResultsModel mModel;
 
     /**
     * @brief Program settings
@@ -315,13 +210,6 @@ protected:
     */
     QSettings *mSettings;
 
-    /**
-    * @brief List of bools to determine which of ShowTypes to display on the tree
-    * (true) and which of them should be hidden (false)
-    *
-    */
-    bool mShowTypes[SHOW_NONE];
-
     /**
     * @brief List of applications to open errors with
     *
@@ -332,7 +220,7 @@ protected:
     * @brief Right clicked item (used by context menu slots)
     *
     */
-    QStandardItem *mContextItem;
+    QPersistentModelIndex mContextItem;
 
     /**
     * @brief Should full path of files be shown (true) or relative (false)
@@ -358,12 +246,6 @@ protected:
     */
     QString mCheckPath;
 
-    /**
-    * @brief Are there any visible errors
-    *
-    */
-    bool mVisibleErrors;
-
 private:
 };
 /// @}
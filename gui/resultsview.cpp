@@ -104,15 +104,15 @@ void ResultsView::Progress(int value, int max)
     }
 }
 
-void ResultsView::Error(const QString &file,
-                        const QString &severity,
-                        const QString &message,
-                        const QStringList &files,
-                        const QVariantList &lines,
-                        const QString &id)
+void ResultsView::Errors(const QList<ErrorItem> &errors)
 {
     mErrorsFound = true;
-    mUI.mTree->AddErrorItem(file, severity, message, files, lines, id);
+
+    // Add the whole batch before the tree is painted again
+    mUI.mTree->setUpdatesEnabled(false);
+    mUI.mTree->AddErrors(errors);
+    mUI.mTree->setUpdatesEnabled(true);
+
     emit GotResults();
 }
 
@@ -23,7 +23,9 @@
 
 #include <QWidget>
 #include <QProgressBar>
+#include <QList>
 #include "../src/errorlogger.h"
+#include "erroritem.h"
 #include "resultstree.h"
 #include "common.h"
 #include "report.h"
@@ -142,20 +144,11 @@ public slots:
     void Progress(int value, int max);
 
     /**
-    * @brief Slot for new error to be displayed
+    * @brief Slot for new errors to be displayed
     *
-    * @param file filename
-    * @param severity error severity
-    * @param message error message
-    * @param files list of files affected by the error
-    * @param lines list of file line numers affected by the error
-    */
-    void Error(const QString &file,
-               const QString &severity,
-               const QString &message,
-               const QStringList &files,
-               const QVariantList &lines,
-               const QString &error);
+    * @param errors the errors, see ThreadResult::Errors()
+    */
+    void Errors(const QList<ErrorItem> &errors);
 
     /**
     * @brief Collapse all results in the result list.
@@ -106,12 +106,14 @@ void ThreadHandler::RemoveThreads()
 {
     for (int i = 0; i < mThreads.size(); i++)
     {
-        mThreads[i]->terminate();
-        disconnect(mThreads.last(), SIGNAL(Done()),
+        disconnect(mThreads[i], SIGNAL(Done()),
                    this, SLOT(ThreadDone()));
-        disconnect(mThreads.last(), SIGNAL(FileChecked(const QString &)),
+        disconnect(mThreads[i], SIGNAL(FileChecked(const QString &)),
                    &mResults, SLOT(FileChecked(const QString &)));
 
+        // The thread stops between the checking phases of the file
+        mThreads[i]->stop();
+        mThreads[i]->wait();
         delete mThreads[i];
     }
 
@@ -141,18 +143,8 @@ void ThreadHandler::Initialize(ResultsView *view)
     connect(&mResults, SIGNAL(Progress(int, int)),
             view, SLOT(Progress(int, int)));
 
-    connect(&mResults, SIGNAL(Error(const QString &,
-                                    const QString &,
-                                    const QString &,
-                                    const QStringList &,
-                                    const QVariantList &,
-                                    const QString &)),
-            view, SLOT(Error(const QString &,
-                             const QString &,
-                             const QString &,
-                             const QStringList &,
-                             const QVariantList &,
-                             const QString &)));
+    connect(&mResults, SIGNAL(Errors(const QList<ErrorItem> &)),
+            view, SLOT(Errors(const QList<ErrorItem> &)));
 
 }
 
@@ -19,8 +19,32 @@
 
 #include "threadresult.h"
 #include <QDebug>
-
-ThreadResult::ThreadResult() : mMaxProgress(0), mProgress(0)
+#include <QThread>
+#include <QTimer>
+
+/**
+* @brief How often (ms) the errors are delivered while a file is checked
+*
+*/
+static const int ERROR_FLUSH_INTERVAL = 50;
+
+/**
+* @brief Progress steps per file, so that the progress moves while a big
+* file is checked
+*
+*/
+static const int PROGRESS_STEPS = 100;
+
+/**
+* @brief The phases of a configuration, in the order they are reported.
+* "check" is any stage that starts with "check": the checks are run
+* both before and after the token list is simplified.
+*
+*/
+static const char * const PROGRESS_STAGES[] = { "preprocess", "tokenize", "check", "simplify", "match", "check" };
+static const int PROGRESS_STAGE_COUNT = sizeof(PROGRESS_STAGES) / sizeof(PROGRESS_STAGES[0]);
+
+ThreadResult::ThreadResult() : mMaxProgress(0), mProgress(0), mFlushScheduled(false)
 {
     //ctor
 }
@@ -37,36 +61,72 @@ void ThreadResult::reportOut(const std::string &outmsg)
 
 void ThreadResult::FileChecked(const QString &file)
 {
+    // The errors of the file are shown before the progress
+    FlushErrors();
+
     QMutexLocker locker(&mutex);
-    Q_UNUSED(file); //For later use maybe?
     mProgress++;
-    emit Progress(mProgress, mMaxProgress);
+    mFileProgress.remove(qMakePair(sender(), file));
+    mFileSteps.remove(qMakePair(sender(), file));
+    EmitProgress();
 }
 
-void ThreadResult::reportErr(const ErrorLogger::ErrorMessage &msg)
+void ThreadResult::EmitProgress()
 {
-    QMutexLocker locker(&mutex);
+    int progress = mProgress * PROGRESS_STEPS;
+    int fileProgress;
+    foreach(fileProgress, mFileProgress)
+    {
+        progress += fileProgress;
+    }
+    emit Progress(progress, mMaxProgress * PROGRESS_STEPS);
+}
 
-    QVariantList lines;
-    QStringList files;
+void ThreadResult::reportErr(const ErrorLogger::ErrorMessage &msg)
+{
+    ErrorItem item;
+    item.file = QString(callStackToString(msg._callStack).c_str());
+    item.severity = QString(msg._severity.c_str());
+    item.message = QString(msg._msg.c_str());
+    item.id = QString(msg._id.c_str());
 
     for (std::list<ErrorLogger::ErrorMessage::FileLocation>::const_iterator tok = msg._callStack.begin();
          tok != msg._callStack.end();
          ++tok)
     {
-        files << QString((*tok).file.c_str());
-        lines << (*tok).line;
+        item.files << QString((*tok).file.c_str());
+        item.lines << (*tok).line;
     }
 
-    emit Error(QString(callStackToString(msg._callStack).c_str()),
-               QString(msg._severity.c_str()),
-               QString(msg._msg.c_str()),
-               files,
-               lines,
-               QString(msg._id.c_str()));
+    QMutexLocker locker(&mutex);
+    mErrors << item;
 
+    // This is called in the checking threads. Post only one event for the
+    // errors that are found until they are delivered.
+    if (!mFlushScheduled)
+    {
+        mFlushScheduled = true;
+        QMetaObject::invokeMethod(this, "ScheduleFlush", Qt::QueuedConnection);
+    }
+}
 
+void ThreadResult::ScheduleFlush()
+{
+    QTimer::singleShot(ERROR_FLUSH_INTERVAL, this, SLOT(FlushErrors()));
+}
 
+void ThreadResult::FlushErrors()
+{
+    QList<ErrorItem> errors;
+    {
+        QMutexLocker locker(&mutex);
+        errors = mErrors;
+        mErrors.clear();
+        mFlushScheduled = false;
+    }
+
+    if (!errors.isEmpty())
+        emit Errors(errors);
 }
 
 QString ThreadResult::GetNextFile()
@@ -87,11 +147,52 @@ void ThreadResult::reportStatus(unsigned int index, unsigned int max)
     Q_UNUSED(max);
 }
 
+void ThreadResult::reportProgress(const std::string &filename, const std::string &stage, unsigned int cfg, unsigned int cfgCount, unsigned int value)
+{
+    Q_UNUSED(value);
+
+    if (cfg == 0 || cfg > cfgCount)
+        return;
+
+    // This is called in the checking threads
+    QMutexLocker locker(&mutex);
+    const QPair<QObject *, QString> key = qMakePair(static_cast<QObject *>(QThread::currentThread()), QString(filename.c_str()));
+    int &currentSteps = mFileSteps[key];
+
+    // The first phase of this configuration with the name of the stage
+    // that the file has not yet passed. The checks before and after the
+    // simplification get their own steps this way.
+    const int firstStep = static_cast<int>(cfg - 1) * PROGRESS_STAGE_COUNT;
+    int steps = -1;
+    for (int i = 0; i < PROGRESS_STAGE_COUNT && steps < 0; i++)
+    {
+        const std::string name(PROGRESS_STAGES[i]);
+        const bool match = (name == "check") ? (stage.compare(0, name.size(), name) == 0) : (stage == name);
+        if (match && firstStep + i >= currentSteps)
+            steps = firstStep + i;
+    }
+    if (steps <= currentSteps)
+        return;
+    currentSteps = steps;
+
+    // The file is done when all the phases of all the configurations
+    // are done, FileChecked() reports that
+    const int fileProgress = PROGRESS_STEPS * steps / (static_cast<int>(cfgCount) * PROGRESS_STAGE_COUNT);
+    int &current = mFileProgress[key];
+    if (fileProgress > current)
+    {
+        current = fileProgress;
+        EmitProgress();
+    }
+}
+
 void ThreadResult::SetFiles(const QStringList &files)
 {
     QMutexLocker locker(&mutex);
     mFiles = files;
     mProgress = 0;
+    mFileProgress.clear();
+    mFileSteps.clear();
     mMaxProgress = files.size();
 }
 
@@ -22,9 +22,13 @@
 
 #include <QMutex>
 #include <QObject>
+#include <QList>
+#include <QHash>
+#include <QPair>
 #include <QStringList>
 #include <QVariant>
 #include "../src/errorlogger.h"
+#include "erroritem.h"
 
 /// @addtogroup GUI
 /// @{
@@ -70,6 +74,7 @@ public:
     void reportOut(const std::string &outmsg);
     void reportErr(const ErrorLogger::ErrorMessage &msg);
     void reportStatus(unsigned int index, unsigned int max);
+    void reportProgress(const std::string &filename, const std::string &stage, unsigned int cfg, unsigned int cfgCount, unsigned int value);
 public slots:
 
     /**
@@ -77,6 +82,23 @@ public slots:
     * @param file File taht is checked
     */
     void FileChecked(const QString &file);
+
+protected slots:
+
+    /**
+    * @brief Deliver the errors that have been found since the last call
+    * to the results view, see Errors()
+    *
+    */
+    void FlushErrors();
+
+    /**
+    * @brief Deliver the errors after a while, so that the errors that are
+    * found meanwhile are delivered at the same time
+    *
+    */
+    void ScheduleFlush();
+
 signals:
     /**
     * @brief Progress signal
@@ -86,20 +108,13 @@ signals:
     void Progress(int value, int max);
 
     /**
-    * @brief Signal of a new error
+    * @brief Signal of new errors. The errors are collected from the threads
+    * and delivered when a file is checked or every ERROR_FLUSH_INTERVAL ms,
+    * instead of one signal per error.
     *
-    * @param file filename
-    * @param severity error severity
-    * @param message error message
-    * @param files list of files affected by the error
-    * @param lines list of file line numers affected by the error
-    */
-    void Error(const QString &file,
-               const QString &severity,
-               const QString &message,
-               const QStringList &files,
-               const QVariantList &lines,
-               const QString &id);
+    * @param errors the new errors
+    */
+    void Errors(const QList<ErrorItem> &errors);
 
 protected:
 
@@ -126,6 +141,42 @@ protected:
     *
     */
     int mProgress;
+
+    /**
+    * @brief Progress in the files that are being checked, in
+    * PROGRESS_STEPS per file. The key is the thread that checks the file
+    * and the file name. A thread can report the progress of its next file
+    * before FileChecked() of the previous file is delivered.
+    *
+    */
+    QHash<QPair<QObject *, QString>, int> mFileProgress;
+
+    /**
+    * @brief The last phase that the files that are being checked have
+    * reached, see reportProgress(). The key is the same as in
+    * mFileProgress.
+    *
+    */
+    QHash<QPair<QObject *, QString>, int> mFileSteps;
+
+    /**
+    * @brief Errors that are not yet delivered, see FlushErrors()
+    *
+    */
+    QList<ErrorItem> mErrors;
+
+    /**
+    * @brief Is FlushErrors() already scheduled for the errors in mErrors
+    *
+    */
+    bool mFlushScheduled;
+
+    /**
+    * @brief Emit the progress of the checked files and the files that
+    * are being checked. The mutex must be locked.
+    *
+    */
+    void EmitProgress();
 private:
 };
 /// @}
@@ -48,7 +48,8 @@ void TxtReport::WriteHeader()
 
 void TxtReport::WriteFooter()
 {
-    // No footer for txt report
+    // No footer for txt report, just write out the buffered lines
+    mTxtWriter.flush();
 }
 
 void TxtReport::WriteError(const QStringList &files, const QStringList &lines,
@@ -79,5 +80,5 @@ void TxtReport::WriteError(const QStringList &files, const QStringList &lines,
 
     line += QString("(%1) %2").arg(severity).arg(msg);
 
-    mTxtWriter << line << endl;
+    mTxtWriter << line << "\n";
 }
\ No newline at end of file
@@ -23,6 +23,7 @@
 #include "tokenize.h"
 #include "settings.h"
 #include "errorlogger.h"
+#include "tokenmatcher.h"
 
 #include <list>
 #include <iostream>
@@ -34,7 +35,7 @@
  * @brief Interface class that cppcheck uses to communicate with the checks.
  * All checking classes must inherit from this class
  */
-class Check
+class Check : public TokenMatcher::Listener
 {
 public:
     /** This constructor is used when registering the CheckClass */
@@ -69,6 +70,60 @@ public:
     /** run checks, the token list is simplified */
     virtual void runSimplifiedChecks(const Tokenizer *tokenizer, const Settings *settings, ErrorLogger *errorLogger) = 0;
 
+    /**
+     * Create a check object that finds its errors in the simplified token
+     * list through the TokenMatcher. All these checks share one walk through
+     * the token list. The caller deletes the returned object.
+     * @return new check object or 0 if this check class walks through the
+     * token list on its own.
+     */
+    virtual Check *createMatcherCheck(const Tokenizer *, const Settings *, ErrorLogger *)
+    {
+        return 0;
+    }
+
+    /** register the patterns that this check is interested in */
+    virtual void addPatterns(TokenMatcher &)
+    { }
+
+    /** a pattern that was registered in addPatterns() matched */
+    virtual void patternMatch(const Token *, unsigned int)
+    { }
+
+    /**
+     * Write a summary of the functions in a file. The summaries of all
+     * files are read with readSummary() before any file is checked, so
+     * the checks can see what functions in other files do.
+     * Each line must start with a keyword that the check recognizes.
+     * @param tokenizer the simplified token list of the file
+     * @param settings the settings
+     * @param errorLogger errors found while writing the summary
+     * @param ostr the summary is written here
+     */
+    virtual void writeSummary(const Tokenizer *, const Settings *, ErrorLogger *, std::ostream &)
+    { }
+
+    /**
+     * Read a summary that was written by writeSummary(). The summary may
+     * contain lines from other checks that must be skipped.
+     * @param istr the summary
+     * @param settings the results are saved here
+     */
+    virtual void readSummary(std::istream &, Settings &)
+    { }
+
+    /**
+     * Can this check be run at the same time with other checks? The
+     * checks only read the token list, but if a check for example
+     * builds big token lists of its own or writes debug output, it should
+     * be run alone.
+     * @return true if the check must be run alone
+     */
+    virtual bool exclusive() const
+    {
+        return false;
+    }
+
     /** get error messages */
     virtual void getErrorMessages() = 0;
 
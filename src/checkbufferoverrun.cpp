@@ -29,6 +29,8 @@
 #include <algorithm>
 #include <sstream>
 #include <list>
+#include <map>
+#include <vector>
 #include <cstring>
 
 
@@ -40,6 +42,21 @@
 namespace
 {
 CheckBufferOverrun instance;
+
+/** Position of the tokens that are not inside any block */
+const unsigned int noBlock = ~0U;
+
+/** An array that is found by CheckBufferOverrun::checkGlobalAndLocalVariable */
+struct ArrayInfo
+{
+    std::string varname;
+    unsigned int size;
+    int total_size;
+    unsigned int varid;
+
+    /** Position of the first token that is checked */
+    unsigned int start;
+};
 }
 
 //---------------------------------------------------------------------------
@@ -88,7 +105,7 @@ void CheckBufferOverrun::sizeArgumentAsChar(const Token *tok)
 // Check array usage..
 //---------------------------------------------------------------------------
 
-void CheckBufferOverrun::checkScope(const Token *tok, const char *varname[], const int size, const int total_size, unsigned int varid)
+void CheckBufferOverrun::checkScope(const Token *tok, const char *varname[], const int size, const int total_size, unsigned int varid, const std::vector<const Token *> *usage)
 {
     unsigned int varc = 0;
 
@@ -129,6 +146,18 @@ void CheckBufferOverrun::checkScope(const Token *tok, const char *varname[], con
         }
     }
 
+    if (usage)
+    {
+        // Only the given tokens need to be checked..
+        for (std::vector<const Token *>::const_iterator it = usage->begin(); it != usage->end(); ++it)
+        {
+            tok = *it;
+            if (!checkScopeToken(tok, varnames, varc, size, total_size, varid))
+                return;
+        }
+        return;
+    }
+
     int indentlevel = 0;
     for (; tok; tok = tok->next())
     {
@@ -144,402 +173,410 @@ void CheckBufferOverrun::checkScope(const Token *tok, const char *varname[], con
                 return;
         }
 
-        // Array index..
-        if (varid > 0)
-        {
-            if (!tok->isName() && !Token::Match(tok, "[.&]") && Token::Match(tok->next(), "%varid% [ %num% ]", varid))
-            {
-                const char *num = tok->strAt(3);
-                if (std::strtol(num, NULL, 10) >= size)
-                {
-                    arrayIndexOutOfBounds(tok->next());
-                }
-            }
-        }
-        else if (!tok->isName() && !Token::Match(tok, "[.&]") && Token::Match(tok->next(), std::string(varnames + " [ %num% ]").c_str()))
+        if (!checkScopeToken(tok, varnames, varc, size, total_size, varid))
+            return;
+    }
+}
+
+bool CheckBufferOverrun::checkScopeToken(const Token *&tok, const std::string &varnames, unsigned int varc, const int size, const int total_size, unsigned int varid)
+{
+    // Array index..
+    if (varid > 0)
+    {
+        if (!tok->isName() && !Token::Match(tok, "[.&]") && Token::Match(tok->next(), "%varid% [ %num% ]", varid))
         {
-            const char *num = tok->next()->strAt(2 + varc);
+            const char *num = tok->strAt(3);
             if (std::strtol(num, NULL, 10) >= size)
             {
                 arrayIndexOutOfBounds(tok->next());
             }
-            tok = tok->tokAt(4);
-            continue;
         }
+    }
+    else if (!tok->isName() && !Token::Match(tok, "[.&]") && Token::Match(tok->next(), std::string(varnames + " [ %num% ]").c_str()))
+    {
+        const char *num = tok->next()->strAt(2 + varc);
+        if (std::strtol(num, NULL, 10) >= size)
+        {
+            arrayIndexOutOfBounds(tok->next());
+        }
+        tok = tok->tokAt(4);
+        return true;
+    }
 
 
-        // memset, memcmp, memcpy, strncpy, fgets..
-        if (varid > 0)
+    // memset, memcmp, memcpy, strncpy, fgets..
+    if (varid > 0)
+    {
+        if (Token::Match(tok, "memset|memcpy|memmove|memcmp|strncpy|fgets"))
         {
-            if (Token::Match(tok, "memset|memcpy|memmove|memcmp|strncpy|fgets"))
+            if (Token::Match(tok->next(), "( %varid% , %any% , %any% )", varid) ||
+                Token::Match(tok->next(), "( %var% , %varid% , %any% )", varid))
             {
-                if (Token::Match(tok->next(), "( %varid% , %any% , %any% )", varid) ||
-                    Token::Match(tok->next(), "( %var% , %varid% , %any% )", varid))
+                const Token *tokSz = tok->tokAt(6);
+                if (tokSz->str()[0] == '\'')
+                    sizeArgumentAsChar(tok);
+                else if (tokSz->isNumber())
                 {
-                    const Token *tokSz = tok->tokAt(6);
-                    if (tokSz->str()[0] == '\'')
-                        sizeArgumentAsChar(tok);
-                    else if (tokSz->isNumber())
+                    const char *num  = tok->strAt(6);
+                    if (std::atoi(num) > total_size)
                     {
-                        const char *num  = tok->strAt(6);
-                        if (std::atoi(num) > total_size)
-                        {
-                            bufferOverrun(tok);
-                        }
+                        bufferOverrun(tok);
                     }
                 }
             }
         }
-        else if (Token::Match(tok, "memset|memcpy|memmove|memcmp|strncpy|fgets"))
+    }
+    else if (Token::Match(tok, "memset|memcpy|memmove|memcmp|strncpy|fgets"))
+    {
+        if (Token::Match(tok->next(), std::string("( " + varnames + " , %num% , %num% )").c_str()) ||
+            Token::Match(tok->next(), std::string("( %var% , " + varnames + " , %num% )").c_str()))
         {
-            if (Token::Match(tok->next(), std::string("( " + varnames + " , %num% , %num% )").c_str()) ||
-                Token::Match(tok->next(), std::string("( %var% , " + varnames + " , %num% )").c_str()))
+            const char *num  = tok->strAt(varc + 6);
+            if (std::atoi(num) > total_size)
             {
-                const char *num  = tok->strAt(varc + 6);
-                if (std::atoi(num) > total_size)
-                {
-                    bufferOverrun(tok);
-                }
+                bufferOverrun(tok);
             }
-            continue;
         }
+        return true;
+    }
 
 
-        // Loop..
-        if (Token::simpleMatch(tok, "for ("))
-        {
-            const Token *tok2 = tok->tokAt(2);
+    // Loop..
+    if (Token::simpleMatch(tok, "for ("))
+    {
+        const Token *tok2 = tok->tokAt(2);
 
-            unsigned int counter_varid = 0;
-            std::string min_counter_value;
-            std::string max_counter_value;
+        unsigned int counter_varid = 0;
+        std::string min_counter_value;
+        std::string max_counter_value;
 
-            // for - setup..
-            if (Token::Match(tok2, "%var% = %any% ;"))
+        // for - setup..
+        if (Token::Match(tok2, "%var% = %any% ;"))
+        {
+            if (tok2->tokAt(2)->isNumber())
             {
-                if (tok2->tokAt(2)->isNumber())
-                {
-                    min_counter_value = tok2->strAt(2);
-                }
-
-                counter_varid = tok2->varId();
-                tok2 = tok2->tokAt(4);
+                min_counter_value = tok2->strAt(2);
             }
-            else if (Token::Match(tok2, "%type% %var% = %any% ;"))
-            {
-                if (tok2->tokAt(3)->isNumber())
-                {
-                    min_counter_value = tok2->strAt(3);
-                }
 
-                counter_varid = tok2->next()->varId();
-                tok2 = tok2->tokAt(5);
-            }
-            else if (Token::Match(tok2, "%type% %type% %var% = %any% ;"))
+            counter_varid = tok2->varId();
+            tok2 = tok2->tokAt(4);
+        }
+        else if (Token::Match(tok2, "%type% %var% = %any% ;"))
+        {
+            if (tok2->tokAt(3)->isNumber())
             {
-                if (tok->tokAt(4)->isNumber())
-                {
-                    min_counter_value = tok2->strAt(4);
-                }
+                min_counter_value = tok2->strAt(3);
+            }
 
-                counter_varid = tok2->tokAt(2)->varId();
-                tok2 = tok2->tokAt(6);
+            counter_varid = tok2->next()->varId();
+            tok2 = tok2->tokAt(5);
+        }
+        else if (Token::Match(tok2, "%type% %type% %var% = %any% ;"))
+        {
+            if (tok->tokAt(4)->isNumber())
+            {
+                min_counter_value = tok2->strAt(4);
             }
-            else
-                continue;
 
-            if (counter_varid)
+            counter_varid = tok2->tokAt(2)->varId();
+            tok2 = tok2->tokAt(6);
+        }
+        else
+            return true;
+
+        if (counter_varid)
+        {
+            if (Token::Match(tok2, "%varid% < %num% ;", counter_varid))
             {
-                if (Token::Match(tok2, "%varid% < %num% ;", counter_varid))
-                {
-                    max_counter_value = MathLib::toString<long>(atol(tok2->strAt(2)) - 1);
-                }
-                else if (Token::Match(tok2, "%varid% <= %num% ;", counter_varid))
-                {
-                    max_counter_value = tok2->strAt(2);
-                }
+                max_counter_value = MathLib::toString<long>(atol(tok2->strAt(2)) - 1);
             }
+            else if (Token::Match(tok2, "%varid% <= %num% ;", counter_varid))
+            {
+                max_counter_value = tok2->strAt(2);
+            }
+        }
 
-            // Get index variable and stopsize.
-            const char *strindex = tok2->str().c_str();
-            bool condition_out_of_bounds = true;
-            int value = ((tok2->strAt(1)[1] == '=') ? 1 : 0) + std::atoi(tok2->strAt(2));
-            if (value <= size)
-                condition_out_of_bounds = false;;
-
-            // Goto the end of the for loop..
-            while (tok2 && tok2->str() != ")")
-                tok2 = tok2->next();
-            if (!tok2 || !tok2->tokAt(5))
-                break;
+        // Get index variable and stopsize.
+        const char *strindex = tok2->str().c_str();
+        bool condition_out_of_bounds = true;
+        int value = ((tok2->strAt(1)[1] == '=') ? 1 : 0) + std::atoi(tok2->strAt(2));
+        if (value <= size)
+            condition_out_of_bounds = false;;
 
-            std::ostringstream pattern;
-            pattern << varnames << " [ " << strindex << " ]";
+        // Goto the end of the for loop..
+        while (tok2 && tok2->str() != ")")
+            tok2 = tok2->next();
+        if (!tok2 || !tok2->tokAt(5))
+            return false;
 
-            int indentlevel2 = 0;
-            while ((tok2 = tok2->next()))
-            {
-                if (tok2->str() == ";" && indentlevel2 == 0)
-                    break;
+        std::ostringstream pattern;
+        pattern << varnames << " [ " << strindex << " ]";
 
-                if (tok2->str() == "{")
-                    ++indentlevel2;
+        int indentlevel2 = 0;
+        while ((tok2 = tok2->next()))
+        {
+            if (tok2->str() == ";" && indentlevel2 == 0)
+                break;
 
-                if (tok2->str() == "}")
-                {
-                    --indentlevel2;
-                    if (indentlevel2 <= 0)
-                        break;
-                }
+            if (tok2->str() == "{")
+                ++indentlevel2;
 
-                if (tok2->str() == "if")
-                {
-                    // Bailout
+            if (tok2->str() == "}")
+            {
+                --indentlevel2;
+                if (indentlevel2 <= 0)
                     break;
-                }
+            }
 
-                if (Token::Match(tok2, pattern.str().c_str()) && condition_out_of_bounds)
-                {
-                    bufferOverrun(tok2);
-                    break;
-                }
+            if (tok2->str() == "if")
+            {
+                // Bailout
+                break;
+            }
 
-                else if (varid > 0 && counter_varid > 0 && !min_counter_value.empty() && !max_counter_value.empty())
-                {
-                    int min_index = 0;
-                    int max_index = 0;
+            if (Token::Match(tok2, pattern.str().c_str()) && condition_out_of_bounds)
+            {
+                bufferOverrun(tok2);
+                break;
+            }
 
-                    if (Token::Match(tok2, "%varid% [ %var% +|-|*|/ %num% ]", varid) &&
-                        tok2->tokAt(2)->varId() == counter_varid)
-                    {
-                        char action = *(tok2->strAt(3));
-                        const std::string &second(tok2->tokAt(4)->str());
+            else if (varid > 0 && counter_varid > 0 && !min_counter_value.empty() && !max_counter_value.empty())
+            {
+                int min_index = 0;
+                int max_index = 0;
 
-                        //printf("min_index: %s %c %s\n", min_counter_value.c_str(), action, second.c_str());
-                        //printf("max_index: %s %c %s\n", max_counter_value.c_str(), action, second.c_str());
+                if (Token::Match(tok2, "%varid% [ %var% +|-|*|/ %num% ]", varid) &&
+                    tok2->tokAt(2)->varId() == counter_varid)
+                {
+                    char action = *(tok2->strAt(3));
+                    const std::string &second(tok2->tokAt(4)->str());
 
-                        min_index = atoi(MathLib::calculate(min_counter_value, second, action).c_str());
-                        max_index = atoi(MathLib::calculate(max_counter_value, second, action).c_str());
-                    }
-                    else if (Token::Match(tok2, "%varid% [ %num% +|-|*|/ %var% ]", varid) &&
-                             tok2->tokAt(4)->varId() == counter_varid)
-                    {
-                        char action = *(tok2->strAt(3));
-                        const std::string &first(tok2->tokAt(2)->str());
+                    //printf("min_index: %s %c %s\n", min_counter_value.c_str(), action, second.c_str());
+                    //printf("max_index: %s %c %s\n", max_counter_value.c_str(), action, second.c_str());
 
-                        //printf("min_index: %s %c %s\n", first.c_str(), action, min_counter_value.c_str());
-                        //printf("max_index: %s %c %s\n", first.c_str(), action, max_counter_value.c_str());
+                    min_index = atoi(MathLib::calculate(min_counter_value, second, action).c_str());
+                    max_index = atoi(MathLib::calculate(max_counter_value, second, action).c_str());
+                }
+                else if (Token::Match(tok2, "%varid% [ %num% +|-|*|/ %var% ]", varid) &&
+                         tok2->tokAt(4)->varId() == counter_varid)
+                {
+                    char action = *(tok2->strAt(3));
+                    const std::string &first(tok2->tokAt(2)->str());
 
-                        min_index = atoi(MathLib::calculate(first, min_counter_value, action).c_str());
-                        max_index = atoi(MathLib::calculate(first, max_counter_value, action).c_str());
-                    }
+                    //printf("min_index: %s %c %s\n", first.c_str(), action, min_counter_value.c_str());
+                    //printf("max_index: %s %c %s\n", first.c_str(), action, max_counter_value.c_str());
 
-                    //printf("min_index = %d, max_index = %d, size = %d\n", min_index, max_index, size);
-                    if (min_index >= size || max_index >= size)
-                    {
-                        arrayIndexOutOfBounds(tok2->next());
-                    }
+                    min_index = atoi(MathLib::calculate(first, min_counter_value, action).c_str());
+                    max_index = atoi(MathLib::calculate(first, max_counter_value, action).c_str());
                 }
 
+                //printf("min_index = %d, max_index = %d, size = %d\n", min_index, max_index, size);
+                if (min_index >= size || max_index >= size)
+                {
+                    arrayIndexOutOfBounds(tok2->next());
+                }
             }
-            continue;
+
         }
+        return true;
+    }
 
 
-        // Writing data into array..
-        if (Token::Match(tok, ("strcpy|strcat ( " + varnames + " , %str% )").c_str()))
+    // Writing data into array..
+    if (Token::Match(tok, ("strcpy|strcat ( " + varnames + " , %str% )").c_str()))
+    {
+        int len = 0;
+        const char *str = tok->strAt(varc + 4);
+        while (*str)
         {
-            int len = 0;
-            const char *str = tok->strAt(varc + 4);
-            while (*str)
-            {
-                if (*str == '\\')
-                    ++str;
+            if (*str == '\\')
                 ++str;
-                ++len;
-            }
-            if (len > 2 && len >= (int)size + 2)
-            {
-                bufferOverrun(tok);
-            }
-            continue;
+            ++str;
+            ++len;
         }
-
-
-        // Dangerous usage of strncat..
-        if (varid > 0 && Token::Match(tok, "strncat ( %varid% , %any% , %num% )", varid))
+        if (len > 2 && len >= (int)size + 2)
         {
-            int n = atoi(tok->strAt(6));
-            if (n >= (size - 1))
-                strncatUsage(tok);
+            bufferOverrun(tok);
         }
+        return true;
+    }
 
 
-        // Dangerous usage of strncpy + strncat..
-        if (varid > 0 && Token::Match(tok, "strncpy|strncat ( %varid% , %any% , %num% ) ; strncat ( %varid% , %any% , %num% )", varid))
-        {
-            int n = atoi(tok->strAt(6)) + atoi(tok->strAt(15));
-            if (n > size)
-                strncatUsage(tok->tokAt(9));
-        }
+    // Dangerous usage of strncat..
+    if (varid > 0 && Token::Match(tok, "strncat ( %varid% , %any% , %num% )", varid))
+    {
+        int n = atoi(tok->strAt(6));
+        if (n >= (size - 1))
+            strncatUsage(tok);
+    }
 
 
-        // sprintf..
-        if (varid > 0 && Token::Match(tok, "sprintf ( %varid% , %str% [,)]", varid))
-        {
-            int len = -2;
-            const Token *end = tok->next()->link();
+    // Dangerous usage of strncpy + strncat..
+    if (varid > 0 && Token::Match(tok, "strncpy|strncat ( %varid% , %any% , %num% ) ; strncat ( %varid% , %any% , %num% )", varid))
+    {
+        int n = atoi(tok->strAt(6)) + atoi(tok->strAt(15));
+        if (n > size)
+            strncatUsage(tok->tokAt(9));
+    }
+
+
+    // sprintf..
+    if (varid > 0 && Token::Match(tok, "sprintf ( %varid% , %str% [,)]", varid))
+    {
+        int len = -2;
+        const Token *end = tok->next()->link();
 
-            // check format string
-            const char *fmt = tok->strAt(4);
-            while (*fmt)
+        // check format string
+        const char *fmt = tok->strAt(4);
+        while (*fmt)
+        {
+            if (*fmt == '\\')
             {
-                if (*fmt == '\\')
-                {
-                    ++fmt;
-                }
-                else if (*fmt == '%')
-                {
-                    // FIXME: better handling for format specifiers
-                    fmt += 2;
-                    continue;
-                }
                 ++fmt;
-                ++len;
             }
-
-            if (len >= (int)size)
+            else if (*fmt == '%')
             {
-                bufferOverrun(tok);
+                // FIXME: better handling for format specifiers
+                fmt += 2;
+                continue;
             }
+            ++fmt;
+            ++len;
+        }
+
+        if (len >= (int)size)
+        {
+            bufferOverrun(tok);
+        }
 
-            // check arguments
-            len = 0;
-            for (const Token *tok2 = tok->tokAt(6); tok2 && tok2 != end; tok2 = tok2->next())
+        // check arguments
+        len = 0;
+        for (const Token *tok2 = tok->tokAt(6); tok2 && tok2 != end; tok2 = tok2->next())
+        {
+            if (tok2->str()[0] == '\"')
             {
-                if (tok2->str()[0] == '\"')
+                len -= 2;
+                const char *str = tok2->str().c_str();
+                while (*str)
                 {
-                    len -= 2;
-                    const char *str = tok2->str().c_str();
-                    while (*str)
-                    {
-                        if (*str == '\\')
-                            ++str;
+                    if (*str == '\\')
                         ++str;
-                        ++len;
-                    }
+                    ++str;
+                    ++len;
                 }
             }
-            if (len >= (int)size)
-            {
-                bufferOverrun(tok);
-            }
-        }
-
-        // snprintf..
-        if (varid > 0 && Token::Match(tok, "snprintf ( %varid% , %num% ,", varid))
-        {
-            int n = std::atoi(tok->strAt(4));
-            if (n > size)
-                outOfBounds(tok->tokAt(4), "snprintf size");
         }
-
-        // cin..
-        if (varid > 0 && Token::Match(tok, "cin >> %varid% ;", varid))
+        if (len >= (int)size)
         {
             bufferOverrun(tok);
         }
+    }
 
-        // Function call..
-        // It's not interesting to check what happens when the whole struct is
-        // sent as the parameter, that is checked separately anyway.
-        if (Token::Match(tok, "%var% ("))
-        {
-            // Don't make recursive checking..
-            if (std::find(_callStack.begin(), _callStack.end(), tok) != _callStack.end())
-                continue;
+    // snprintf..
+    if (varid > 0 && Token::Match(tok, "snprintf ( %varid% , %num% ,", varid))
+    {
+        int n = std::atoi(tok->strAt(4));
+        if (n > size)
+            outOfBounds(tok->tokAt(4), "snprintf size");
+    }
 
-            // Only perform this checking if showAll setting is enabled..
-            if (!_settings->_showAll)
-                continue;
+    // cin..
+    if (varid > 0 && Token::Match(tok, "cin >> %varid% ;", varid))
+    {
+        bufferOverrun(tok);
+    }
 
-            unsigned int parlevel = 0, par = 0;
-            for (const Token *tok2 = tok; tok2; tok2 = tok2->next())
-            {
-                if (tok2->str() == "(")
-                {
-                    ++parlevel;
-                }
+    // Function call..
+    // It's not interesting to check what happens when the whole struct is
+    // sent as the parameter, that is checked separately anyway.
+    if (Token::Match(tok, "%var% ("))
+    {
+        // Don't make recursive checking..
+        if (std::find(_callStack.begin(), _callStack.end(), tok) != _callStack.end())
+            return true;
 
-                else if (tok2->str() == ")")
-                {
-                    --parlevel;
-                    if (parlevel < 1)
-                    {
-                        par = 0;
-                        break;
-                    }
-                }
+        // Only perform this checking if showAll setting is enabled..
+        if (!_settings->_showAll)
+            return true;
 
-                else if (parlevel == 1 && (tok2->str() == ","))
-                {
-                    ++par;
-                }
+        unsigned int parlevel = 0, par = 0;
+        for (const Token *tok2 = tok; tok2; tok2 = tok2->next())
+        {
+            if (tok2->str() == "(")
+            {
+                ++parlevel;
+            }
 
-                if (parlevel == 1 && Token::Match(tok2, std::string("[(,] " + varnames + " [,)]").c_str()))
+            else if (tok2->str() == ")")
+            {
+                --parlevel;
+                if (parlevel < 1)
                 {
-                    ++par;
+                    par = 0;
                     break;
                 }
             }
 
-            if (par == 0)
-                continue;
-
-            // Find function..
-            const Token *ftok = _tokenizer->getFunctionTokenByName(tok->str().c_str());
-            if (!ftok)
-                continue;
+            else if (parlevel == 1 && (tok2->str() == ","))
+            {
+                ++par;
+            }
 
-            // Parse head of function..
-            ftok = ftok->tokAt(2);
-            parlevel = 1;
-            while (ftok && parlevel == 1 && par >= 1)
+            if (parlevel == 1 && Token::Match(tok2, std::string("[(,] " + varnames + " [,)]").c_str()))
             {
-                if (ftok->str() == "(")
-                    ++parlevel;
+                ++par;
+                break;
+            }
+        }
 
-                else if (ftok->str() == ")")
-                    --parlevel;
+        if (par == 0)
+            return true;
 
-                else if (ftok->str() == ",")
-                    --par;
+        // Find function..
+        const Token *ftok = _tokenizer->getFunctionTokenByName(tok->str().c_str());
+        if (!ftok)
+            return true;
 
-                else if (par == 1 && parlevel == 1 && Token::Match(ftok, "%var% [,)]"))
-                {
-                    // Parameter name..
-                    const char *parname[2];
-                    parname[0] = ftok->str().c_str();
-                    parname[1] = 0;
-
-                    // Goto function body..
-                    while (ftok && (ftok->str() != "{"))
-                        ftok = ftok->next();
-                    ftok = ftok ? ftok->next() : 0;
-
-                    // Check variable usage in the function..
-                    _callStack.push_back(tok);
-                    checkScope(ftok, parname, size, total_size, 0);
-                    _callStack.pop_back();
-
-                    // break out..
-                    break;
-                }
+        // Parse head of function..
+        ftok = ftok->tokAt(2);
+        parlevel = 1;
+        while (ftok && parlevel == 1 && par >= 1)
+        {
+            if (ftok->str() == "(")
+                ++parlevel;
+
+            else if (ftok->str() == ")")
+                --parlevel;
+
+            else if (ftok->str() == ",")
+                --par;
 
-                ftok = ftok->next();
+            else if (par == 1 && parlevel == 1 && Token::Match(ftok, "%var% [,)]"))
+            {
+                // Parameter name..
+                const char *parname[2];
+                parname[0] = ftok->str().c_str();
+                parname[1] = 0;
+
+                // Goto function body..
+                while (ftok && (ftok->str() != "{"))
+                    ftok = ftok->next();
+                ftok = ftok ? ftok->next() : 0;
+
+                // Check variable usage in the function..
+                _callStack.push_back(tok);
+                checkScope(ftok, parname, size, total_size, 0);
+                _callStack.pop_back();
+
+                // break out..
+                break;
             }
+
+            ftok = ftok->next();
         }
     }
+
+    return true;
 }
 
 
@@ -549,16 +586,79 @@ void CheckBufferOverrun::checkScope(const Token *tok, const char *varname[], con
 
 void CheckBufferOverrun::checkGlobalAndLocalVariable()
 {
+    // All tokens. The positions in this vector are used below.
+    std::vector<const Token *> tokens;
+
+    // For each token, the position of the innermost "{" before it that is
+    // not closed yet. The "}" tokens get the position of the "}" itself.
+    std::vector<unsigned int> block;
+
+    // For each "{", the position of the matching "}"
+    std::vector<unsigned int> blockEnd;
+
+    std::vector<unsigned int> blocks;
+    std::vector<unsigned int> parentheses;
+
+    // Arrays that are declared, and where their names and varids are used.
+    // For each usage the position of the innermost "(" is saved too.
+    std::vector<ArrayInfo> arrays;
+    std::map<unsigned int, std::vector<std::pair<unsigned int, unsigned int> > > varidUsage;
+    std::map<std::string, std::vector<std::pair<unsigned int, unsigned int> > > nameUsage;
+    std::vector<unsigned int> loops;
+
     int indentlevel = 0;
     for (const Token *tok = _tokenizer->tokens(); tok; tok = tok->next())
     {
+        const unsigned int pos = tokens.size();
+        tokens.push_back(tok);
+        blockEnd.push_back(0);
+
         if (tok->str() == "{")
+        {
             ++indentlevel;
+            block.push_back(blocks.empty() ? noBlock : blocks.back());
+            blocks.push_back(pos);
+        }
 
         else if (tok->str() == "}")
+        {
             --indentlevel;
+            if (!blocks.empty())
+            {
+                blockEnd[blocks.back()] = pos;
+                blocks.pop_back();
+            }
+            block.push_back(pos);
+        }
+
+        else
+        {
+            block.push_back(blocks.empty() ? noBlock : blocks.back());
+
+            if (tok->str() == "(")
+                parentheses.push_back(pos);
+            else if (tok->str() == ")" && !parentheses.empty())
+                parentheses.pop_back();
+            else if (tok->str() == "for")
+                loops.push_back(pos);
+        }
 
-        const char *varname[2] = {0};
+        // Usage of a declared array..
+        const unsigned int paren = parentheses.empty() ? 0 : parentheses.back();
+        if (tok->varId() > 0)
+        {
+            std::map<unsigned int, std::vector<std::pair<unsigned int, unsigned int> > >::iterator it = varidUsage.find(tok->varId());
+            if (it != varidUsage.end())
+                it->second.push_back(std::make_pair(pos, paren));
+        }
+        if (tok->isName())
+        {
+            std::map<std::string, std::vector<std::pair<unsigned int, unsigned int> > >::iterator it = nameUsage.find(tok->str());
+            if (it != nameUsage.end())
+                it->second.push_back(std::make_pair(pos, paren));
+        }
+
+        const char *varname = 0;
         unsigned int size = 0;
         const char *type = 0;
         unsigned int varid = 0;
@@ -573,7 +673,7 @@ void CheckBufferOverrun::checkGlobalAndLocalVariable()
             unsigned int varpos = 1;
             if (tok->next()->str() == "*")
                 ++varpos;
-            varname[0] = tok->strAt(varpos);
+            varname = tok->strAt(varpos);
             size = std::strtoul(tok->strAt(varpos + 2), NULL, 10);
             type = tok->strAt(varpos - 1);
             varid = tok->tokAt(varpos)->varId();
@@ -581,7 +681,7 @@ void CheckBufferOverrun::checkGlobalAndLocalVariable()
         }
         else if (indentlevel > 0 && Token::Match(tok, "[*;{}] %var% = new %type% [ %num% ]"))
         {
-            varname[0] = tok->strAt(1);
+            varname = tok->strAt(1);
             size = std::strtoul(tok->strAt(6), NULL, 10);
             type = tok->strAt(4);
             varid = tok->tokAt(1)->varId();
@@ -589,7 +689,7 @@ void CheckBufferOverrun::checkGlobalAndLocalVariable()
         }
         else if (indentlevel > 0 && Token::Match(tok, "[*;{}] %var% = malloc ( %num% ) ;"))
         {
-            varname[0] = tok->strAt(1);
+            varname = tok->strAt(1);
             size = std::strtoul(tok->strAt(5), NULL, 10);
             type = "char";
             varid = tok->tokAt(1)->varId();
@@ -604,9 +704,88 @@ void CheckBufferOverrun::checkGlobalAndLocalVariable()
         if (total_size == 0)
             continue;
 
+        ArrayInfo array;
+        array.varname = varname;
+        array.size = size;
+        array.total_size = total_size;
+        array.varid = varid;
+        array.start = pos + nextTok;
+        arrays.push_back(array);
+
+        // Remember where the array is used from now on..
+        varidUsage[varid];
+        nameUsage[varname];
+    }
+
+    // Check the arrays in the order they are declared..
+    for (std::vector<ArrayInfo>::const_iterator array = arrays.begin(); array != arrays.end(); ++array)
+    {
+        // The scope ends..
+        if (array->start >= tokens.size())
+            continue;
+        const unsigned int start = array->start;
+        const Token *tok = tokens[start];
+        const char *varname[2] = { array->varname.c_str(), 0 };
+
         // The callstack is empty
         _callStack.clear();
-        checkScope(tok->tokAt(nextTok), varname, size, total_size, varid);
+
+        if (array->varid == 0 || _allTokens)
+        {
+            checkScope(tok, varname, array->size, array->total_size, array->varid);
+            continue;
+        }
+
+        // Where the scope of the array ends..
+        unsigned int end;
+        if (tok->str() == "}")
+            end = start;
+        else if (block[start] == noBlock)
+            end = tokens.size();
+        else
+            end = blockEnd[block[start]];
+
+        // The tokens where checkScopeToken may find something, see the
+        // documentation of checkScopeToken and UsageOffset.
+        std::vector<unsigned int> positions;
+        unsigned int last = start;
+        const std::vector<std::pair<unsigned int, unsigned int> > *usages[2] =
+        {
+            &varidUsage[array->varid],
+            &nameUsage[array->varname]
+        };
+        for (unsigned int i = 0; i < 2; ++i)
+        {
+            std::vector<std::pair<unsigned int, unsigned int> >::const_iterator it;
+            it = std::lower_bound(usages[i]->begin(), usages[i]->end(), std::make_pair(start, 0U));
+            for (; it != usages[i]->end() && it->first < end; ++it)
+            {
+                last = std::max(last, it->first);
+                if (it->first >= BeforeUsage)
+                    positions.push_back(it->first - BeforeUsage);
+                if (it->first >= BeforeShift)
+                    positions.push_back(it->first - BeforeShift);
+                if (it->second > 0)
+                    positions.push_back(it->second - 1);
+            }
+        }
+
+        std::vector<unsigned int>::const_iterator loop = std::lower_bound(loops.begin(), loops.end(), start);
+        for (; loop != loops.end() && *loop < last; ++loop)
+            positions.push_back(*loop);
+
+        std::sort(positions.begin(), positions.end());
+        positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+
+        std::vector<const Token *> scope;
+        for (std::vector<unsigned int>::const_iterator it = positions.begin(); it != positions.end(); ++it)
+        {
+            // Skip positions outside the scope
+            if (*it >= start && *it < end)
+                scope.push_back(tokens[*it]);
+        }
+
+        checkScope(tok, varname, array->size, array->total_size, array->varid, &scope);
     }
 }
 //---------------------------------------------------------------------------
@@ -622,7 +801,11 @@ void CheckBufferOverrun::checkStructVariable()
     for (const Token *tok = Token::findmatch(_tokenizer->tokens(), declstruct);
          tok; tok = Token::findmatch(tok->next(), declstruct))
     {
-        const std::string &structname = tok->next()->str();
+        // The scopes where the members are used. They are the same for all
+        // the arrays, so they are located when the first array is found.
+        bool scopesFound = false;
+        std::vector<const Token *> functions;
+        std::vector<std::pair<const char *, const Token *> > variables;
 
         // Found a struct declaration. Search for arrays..
         for (const Token *tok2 = tok->tokAt(2); tok2; tok2 = tok2->next())
@@ -649,82 +832,106 @@ void CheckBufferOverrun::checkStructVariable()
             if (total_size == 0)
                 continue;
 
+            if (!scopesFound)
+            {
+                scopesFound = true;
+                findStructScopes(tok, functions, variables);
+            }
 
             // Class member variable => Check functions
-            if (tok->str() == "class")
+            for (std::vector<const Token *>::const_iterator it = functions.begin(); it != functions.end(); ++it)
             {
-                std::string func_pattern(structname + " :: %var% (");
-                const Token *tok3 = Token::findmatch(_tokenizer->tokens(), func_pattern.c_str());
-                while (tok3)
-                {
-                    for (const Token *tok4 = tok3; tok4; tok4 = tok4->next())
-                    {
-                        if (Token::Match(tok4, "[;{}]"))
-                            break;
-
-                        if (Token::simpleMatch(tok4, ") {"))
-                        {
-                            const char *names[2] = {varname[1], 0};
-                            checkScope(tok4->tokAt(2), names, arrsize, total_size, 0);
-                            break;
-                        }
-                    }
-                    tok3 = Token::findmatch(tok3->next(), func_pattern.c_str());
-                }
+                const char *names[2] = {varname[1], 0};
+                checkScope(*it, names, arrsize, total_size, 0);
             }
 
-            for (const Token *tok3 = _tokenizer->tokens(); tok3; tok3 = tok3->next())
+            // Check variable usage..
+            for (std::vector<std::pair<const char *, const Token *> >::const_iterator it = variables.begin(); it != variables.end(); ++it)
             {
-                if (tok3->str() != structname)
-                    continue;
+                varname[0] = it->first;
+                checkScope(it->second, varname, arrsize, total_size, 0);
+            }
+        }
+    }
+}
 
-                // Declare variable: Fred fred1;
-                if (Token::Match(tok3->next(), "%var% ;"))
-                    varname[0] = tok3->strAt(1);
+void CheckBufferOverrun::findStructScopes(const Token *tok, std::vector<const Token *> &functions, std::vector<std::pair<const char *, const Token *> > &variables)
+{
+    const std::string &structname = tok->next()->str();
 
-                // Declare pointer: Fred *fred1
-                else if (Token::Match(tok3->next(), "* %var% [,);=]"))
-                    varname[0] = tok3->strAt(2);
+    // Class => member functions
+    if (tok->str() == "class")
+    {
+        std::string func_pattern(structname + " :: %var% (");
+        const Token *tok3 = Token::findmatch(_tokenizer->tokens(), func_pattern.c_str());
+        while (tok3)
+        {
+            for (const Token *tok4 = tok3; tok4; tok4 = tok4->next())
+            {
+                if (Token::Match(tok4, "[;{}]"))
+                    break;
 
-                else
-                    continue;
+                if (Token::simpleMatch(tok4, ") {"))
+                {
+                    functions.push_back(tok4->tokAt(2));
+                    break;
+                }
+            }
+            tok3 = Token::findmatch(tok3->next(), func_pattern.c_str());
+        }
+    }
 
+    for (const Token *tok3 = _tokenizer->tokens(); tok3; tok3 = tok3->next())
+    {
+        if (tok3->str() != structname)
+            continue;
 
-                // Goto end of statement.
-                const Token *CheckTok = NULL;
-                while (tok3)
-                {
-                    // End of statement.
-                    if (tok3->str() == ";")
-                    {
-                        CheckTok = tok3;
-                        break;
-                    }
+        const char *varname = 0;
 
-                    // End of function declaration..
-                    if (Token::simpleMatch(tok3, ") ;"))
-                        break;
+        // Declare variable: Fred fred1;
+        if (Token::Match(tok3->next(), "%var% ;"))
+            varname = tok3->strAt(1);
 
-                    // Function implementation..
-                    if (Token::simpleMatch(tok3, ") {"))
-                    {
-                        CheckTok = tok3->tokAt(2);
-                        break;
-                    }
+        // Declare pointer: Fred *fred1
+        else if (Token::Match(tok3->next(), "* %var% [,);=]"))
+            varname = tok3->strAt(2);
 
-                    tok3 = tok3->next();
-                }
+        else
+            continue;
 
-                if (!tok3)
-                    break;
 
-                if (!CheckTok)
-                    continue;
+        // Goto end of statement.
+        const Token *CheckTok = NULL;
+        while (tok3)
+        {
+            // End of statement.
+            if (tok3->str() == ";")
+            {
+                CheckTok = tok3;
+                break;
+            }
 
-                // Check variable usage..
-                checkScope(CheckTok, varname, arrsize, total_size, 0);
+            // End of function declaration..
+            if (Token::simpleMatch(tok3, ") ;"))
+                break;
+
+            // Function implementation..
+            if (Token::simpleMatch(tok3, ") {"))
+            {
+                CheckTok = tok3->tokAt(2);
+                break;
             }
+
+            tok3 = tok3->next();
         }
+
+        if (!tok3)
+            break;
+
+        if (!CheckTok)
+            continue;
+
+        variables.push_back(std::make_pair(varname, CheckTok));
     }
 }
 //---------------------------------------------------------------------------
@@ -25,6 +25,8 @@
 #include "check.h"
 #include "settings.h"
 #include <list>
+#include <string>
+#include <vector>
 
 class ErrorLogger;
 class Token;
@@ -39,12 +41,12 @@ class CheckBufferOverrun : public Check
 public:
 
     /** This constructor is used when registering the CheckClass */
-    CheckBufferOverrun() : Check()
+    CheckBufferOverrun() : Check(), _allTokens(false)
     { }
 
     /** This constructor is used when running checks.. */
     CheckBufferOverrun(const Tokenizer *tokenizer, const Settings *settings, ErrorLogger *errorLogger)
-            : Check(tokenizer, settings, errorLogger)
+            : Check(tokenizer, settings, errorLogger), _allTokens(false)
     { }
 
     void runSimplifiedChecks(const Tokenizer *tokenizer, const Settings *settings, ErrorLogger *errorLogger)
@@ -56,16 +58,75 @@ public:
 
     /** Check for buffer overruns */
     void bufferOverrun();
+
+    /**
+     * Check all the tokens in the scopes of the local and global arrays,
+     * not only the tokens where the arrays are used. The results must be
+     * the same, the tests use this to find patterns in checkScopeToken
+     * that UsageOffset doesn't cover.
+     */
+    void allTokens()
+    {
+        _allTokens = true;
+    }
 private:
 
+    /** Check all the tokens, see allTokens() */
+    bool _allTokens;
+
     /** Check for buffer overruns - locate struct variables and check them with the .._CheckScope function */
     void checkStructVariable();
 
+    /**
+     * Locate the code where the members of a struct or class are used
+     * @param tok the "struct" or "class" token of the declaration
+     * @param functions the bodies of the member functions of a class
+     * @param variables the declared variables and the tokens where their usage starts
+     */
+    void findStructScopes(const Token *tok, std::vector<const Token *> &functions, std::vector<std::pair<const char *, const Token *> > &variables);
+
+    /**
+     * Where the patterns in checkScopeToken start, counted backwards from a
+     * usage of the array. The "%var% ( .. arr .." patterns (memset, strcpy,
+     * sprintf, function calls, ..) are not listed, they start right before
+     * the "(" that the usage is in. TestBufferOverrun checks every test
+     * case with allTokens() too, so a pattern that is not covered here
+     * makes the tests fail.
+     */
+    enum UsageOffset
+    {
+        /** "[;=(..] arr [ num ]" - array index */
+        BeforeUsage = 1,
+        /** "cin >> arr ;" */
+        BeforeShift = 2
+    };
+
     /** Check for buffer overruns - locate global variables and local function variables and check them with the checkScope function */
     void checkGlobalAndLocalVariable();
 
-    /** Check for buffer overruns - this is the function that performs the actual checking */
-    void checkScope(const Token *tok, const char *varname[], const int size, const int total_size, unsigned int varid);
+    /**
+     * Check for buffer overruns - this is the function that performs the actual checking
+     * @param tok the first token of the scope
+     * @param varname the variable name, the names of the struct members are given as separate strings
+     * @param size number of elements in the array
+     * @param total_size size of the array in bytes
+     * @param varid varid of the array, 0 if it's not known
+     * @param usage if given, only these tokens of the scope are checked. The rest of the scope
+     *              must not contain anything that checkScopeToken would find.
+     */
+    void checkScope(const Token *tok, const char *varname[], const int size, const int total_size, unsigned int varid, const std::vector<const Token *> *usage = 0);
+
+    /**
+     * Check one token of the scope, see checkScope.
+     * checkGlobalAndLocalVariable only gives this function the tokens where
+     * one of its patterns can start:
+     * - the UsageOffset tokens before a usage of the array
+     * - the token before the innermost "(" that a usage is in
+     * - the "for (" loops before the last usage
+     * A new pattern that starts anywhere else must be added to UsageOffset.
+     * @return false if the rest of the scope must not be checked
+     */
+    bool checkScopeToken(const Token *&tok, const std::string &varnames, unsigned int varc, const int size, const int total_size, unsigned int varid);
 
     /** callstack - used during intra-function checking */
     std::list<const Token *> _callStack;
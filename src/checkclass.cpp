@@ -27,8 +27,7 @@
 
 #include <cstring>
 #include <string>
-#include <sstream>
-#include <algorithm>
+#include <list>
 
 //---------------------------------------------------------------------------
 
@@ -41,10 +40,72 @@ CheckClass instance;
 
 //---------------------------------------------------------------------------
 
-CheckClass::Var *CheckClass::getVarList(const Token *tok1, bool withClasses)
+CheckClass::ClassModel &CheckClass::getClassModel()
 {
+    if (_classModelCreated)
+        return _classModel;
+    _classModelCreated = true;
+
+    // Classes that no constructor has been seen for yet..
+    std::map<std::string, std::vector<unsigned int> > noConstructor;
+
+    for (const Token *tok = _tokenizer->tokens(); tok; tok = tok->next())
+    {
+        if (tok->str() == "class" && tok->next())
+        {
+            const std::string &classname = tok->next()->str();
+            _classModel.classNames.insert(classname);
+
+            if (Token::Match(tok, "class %var% [{:]"))
+            {
+                noConstructor[classname].push_back(_classModel.classes.size());
+                _classModel.classes.push_back(ClassModel::Class(tok));
+
+                if (tok->strAt(2)[0] == '{' && _classModel.declarations.find(classname) == _classModel.declarations.end())
+                    _classModel.declarations[classname] = tok;
+            }
+        }
+
+        else if (tok->str() == "enum" && tok->next())
+            _classModel.enums.insert(tok->next()->str());
+
+        else if (Token::Match(tok, "%var% :: %var% ="))
+            _classModel.staticMembers.insert(std::make_pair(tok->str(), tok->strAt(2)));
+
+        else if (Token::Match(tok, "~ %var% ( ) {") &&
+                 _classModel.destructorImplementations.find(tok->strAt(1)) == _classModel.destructorImplementations.end())
+            _classModel.destructorImplementations[tok->strAt(1)] = tok;
+
+        if (tok->str() != "::" && Token::Match(tok->next(), "~ %var% (") &&
+            _classModel.destructors.find(tok->strAt(2)) == _classModel.destructors.end())
+            _classModel.destructors[tok->strAt(2)] = tok;
+
+        // Constructor..
+        if (tok->str() != "~" && Token::Match(tok->next(), "%var% ("))
+        {
+            std::map<std::string, std::vector<unsigned int> >::iterator it = noConstructor.find(tok->strAt(1));
+            if (it != noConstructor.end())
+            {
+                for (std::vector<unsigned int>::const_iterator i = it->second.begin(); i != it->second.end(); ++i)
+                    _classModel.classes[*i].hasConstructor = true;
+                noConstructor.erase(it);
+            }
+        }
+    }
+
+    return _classModel;
+}
+//---------------------------------------------------------------------------
+
+const std::vector<CheckClass::Var> &CheckClass::getVarList(const Token *tok1, bool withClasses)
+{
+    std::map<std::pair<const Token *, bool>, std::vector<Var> > &varlists = getClassModel().varlists;
+    const std::pair<const Token *, bool> key(tok1, withClasses);
+    if (varlists.find(key) != varlists.end())
+        return varlists[key];
+
     // Get variable list..
-    Var *varlist = NULL;
+    std::vector<Var> &varlist = varlists[key];
     unsigned int indentlevel = 0;
     for (const Token *tok = tok1; tok; tok = tok->next())
     {
@@ -93,7 +154,7 @@ CheckClass::Var *CheckClass::getVarList(const Token *tok1, bool withClasses)
                 varname = next->strAt(1);
             else if (next->isStandardType())
                 varname = next->strAt(1);
-            else if (Token::findmatch(_tokenizer->tokens(), ("enum " + next->str()).c_str()))
+            else if (getClassModel().enums.find(next->str()) != getClassModel().enums.end())
                 varname = next->strAt(1);
         }
 
@@ -126,19 +187,16 @@ CheckClass::Var *CheckClass::getVarList(const Token *tok1, bool withClasses)
 
         // If the varname was set in one of the two if-block above, create a entry for this variable..
         if (varname)
-        {
-            Var *var = new Var(varname, false, varlist);
-            varlist   = var;
-        }
+            varlist.push_back(Var(varname, false));
     }
 
     return varlist;
 }
 //---------------------------------------------------------------------------
 
-void CheckClass::initVar(Var *varlist, const char varname[])
+void CheckClass::initVar(std::vector<Var> &varlist, const char varname[])
 {
-    for (Var *var = varlist; var; var = var->next)
+    for (std::vector<Var>::iterator var = varlist.begin(); var != varlist.end(); ++var)
     {
         if (strcmp(var->name, varname) == 0)
         {
@@ -149,7 +207,22 @@ void CheckClass::initVar(Var *varlist, const char varname[])
 }
 //---------------------------------------------------------------------------
 
-void CheckClass::initializeVarList(const Token *tok1, const Token *ftok, Var *varlist, const char classname[], std::list<std::string> &callstack)
+const Token *CheckClass::findClassFunction(const Token *tok1, const std::string &funcname)
+{
+    std::map<std::pair<const Token *, std::string>, const Token *> &functions = getClassModel().functions;
+    const std::pair<const Token *, std::string> key(tok1, funcname);
+    std::map<std::pair<const Token *, std::string>, const Token *>::const_iterator it = functions.find(key);
+    if (it != functions.end())
+        return it->second;
+
+    int indentlevel = 0;
+    const Token *ftok = Tokenizer::findClassFunction(tok1, tok1->strAt(1), funcname.c_str(), indentlevel);
+    functions[key] = ftok;
+    return ftok;
+}
+//---------------------------------------------------------------------------
+
+void CheckClass::initializeVarList(const Token *tok1, const Token *ftok, std::vector<Var> &varlist, const char classname[], std::set<std::string> &callstack)
 {
     bool Assign = false;
     unsigned int indentlevel = 0;
@@ -201,7 +274,7 @@ void CheckClass::initializeVarList(const Token *tok1, const Token *ftok, Var *va
         // Using the operator= function to initialize all variables..
         if (Token::simpleMatch(ftok->next(), "* this = "))
         {
-            for (Var *var = varlist; var; var = var->next)
+            for (std::vector<Var>::iterator var = varlist.begin(); var != varlist.end(); ++var)
                 var->init = true;
             break;
         }
@@ -219,7 +292,7 @@ void CheckClass::initializeVarList(const Token *tok1, const Token *ftok, Var *va
         // Clearing all variables..
         if (Token::simpleMatch(ftok, "memset ( this ,"))
         {
-            for (Var *var = varlist; var; var = var->next)
+            for (std::vector<Var>::iterator var = varlist.begin(); var != varlist.end(); ++var)
                 var->init = true;
             break;
         }
@@ -228,11 +301,10 @@ void CheckClass::initializeVarList(const Token *tok1, const Token *ftok, Var *va
         else if (Token::Match(ftok, "%var% ("))
         {
             // No recursive calls!
-            if (std::find(callstack.begin(), callstack.end(), ftok->str()) == callstack.end())
+            if (callstack.find(ftok->str()) == callstack.end())
             {
-                callstack.push_back(ftok->str());
-                int i = 0;
-                const Token *ftok2 = Tokenizer::findClassFunction(tok1, classname, ftok->str().c_str(), i);
+                callstack.insert(ftok->str());
+                const Token *ftok2 = findClassFunction(tok1, ftok->str());
                 initializeVarList(tok1, ftok2, varlist, classname, callstack);
             }
         }
@@ -262,12 +334,11 @@ void CheckClass::initializeVarList(const Token *tok1, const Token *ftok, Var *va
 
 void CheckClass::constructors()
 {
-    const char pattern_class[] = "class %var% [{:]";
-
     // Locate class
-    const Token *tok1 = Token::findmatch(_tokenizer->tokens(), pattern_class);
-    while (tok1)
+    const std::vector<ClassModel::Class> &classes = getClassModel().classes;
+    for (std::vector<ClassModel::Class>::const_iterator it = classes.begin(); it != classes.end(); ++it)
     {
+        const Token *tok1 = it->tok;
         const char *className[2];
         className[0] = tok1->strAt(1);
         className[1] = 0;
@@ -314,38 +385,22 @@ void CheckClass::constructors()
         {
             /** @todo Handle private constructors. Right now to avoid
              * false positives we just bail out */
-            tok1 = Token::findmatch(tok1->next(), pattern_class);
             continue;
         }
 
-        // Are there a class constructor?
-        std::string tempPattern = "%any% " + classNameToken->str() + " (";
-        const Token *constructor_token = Token::findmatch(tok1, tempPattern.c_str());
-        while (constructor_token && constructor_token->str() == "~")
-            constructor_token = Token::findmatch(constructor_token->next(), tempPattern.c_str());
-
         // There are no constructor.
-        if (! constructor_token)
+        if (! it->hasConstructor)
         {
             // If "--style" has been given, give a warning
             if (ErrorLogger::noConstructor(*_settings))
             {
                 // If the class has member variables there should be an constructor
-                Var *varlist = getVarList(tok1, false);
-                if (varlist)
+                if (!getVarList(tok1, false).empty())
                 {
                     noConstructorError(tok1, classNameToken->str());
                 }
-                // Delete the varlist..
-                while (varlist)
-                {
-                    Var *nextvar = varlist->next;
-                    delete varlist;
-                    varlist = nextvar;
-                }
             }
 
-            tok1 = Token::findmatch(tok1->next(), pattern_class);
             continue;
         }
 
@@ -354,8 +409,6 @@ void CheckClass::constructors()
 
         // Check assignment operators
         checkConstructors(tok1, "operator =");
-
-        tok1 = Token::findmatch(tok1->next(), pattern_class);
     }
 }
 
@@ -365,24 +418,22 @@ void CheckClass::checkConstructors(const Token *tok1, const char funcname[])
 
     // Check that all member variables are initialized..
     bool withClasses = bool(_settings->_showAll && std::string(funcname) == "operator =");
-    Var *varlist = getVarList(tok1, withClasses);
+    std::vector<Var> varlist(getVarList(tok1, withClasses));
 
     int indentlevel = 0;
     const Token *constructor_token = Tokenizer::findClassFunction(tok1, className, funcname, indentlevel);
-    std::list<std::string> callstack;
+    std::set<std::string> callstack;
     initializeVarList(tok1, constructor_token, varlist, className, callstack);
     while (constructor_token)
     {
         // Check if any variables are uninitialized
-        for (Var *var = varlist; var; var = var->next)
+        for (std::vector<Var>::const_iterator var = varlist.begin(); var != varlist.end(); ++var)
         {
             if (var->init)
                 continue;
 
             // Is it a static member variable?
-            std::ostringstream pattern;
-            pattern << className << " :: " << var->name << " =";
-            if (Token::findmatch(_tokenizer->tokens(), pattern.str().c_str()))
+            if (getClassModel().staticMembers.find(std::make_pair(std::string(className), std::string(var->name))) != getClassModel().staticMembers.end())
                 continue;
 
             // It's non-static and it's not initialized => error
@@ -412,21 +463,13 @@ void CheckClass::checkConstructors(const Token *tok1, const char funcname[])
                 uninitVarError(constructor_token, className, var->name);
         }
 
-        for (Var *var = varlist; var; var = var->next)
+        for (std::vector<Var>::iterator var = varlist.begin(); var != varlist.end(); ++var)
             var->init = false;
 
         constructor_token = Tokenizer::findClassFunction(constructor_token->next(), className, funcname, indentlevel);
         callstack.clear();
         initializeVarList(tok1, constructor_token, varlist, className, callstack);
     }
-
-    // Delete the varlist..
-    while (varlist)
-    {
-        Var *nextvar = varlist->next;
-        delete varlist;
-        varlist = nextvar;
-    }
 }
 
 
@@ -437,8 +480,19 @@ void CheckClass::checkConstructors(const Token *tok1, const char funcname[])
 void CheckClass::privateFunctions()
 {
     // Locate some class
-    for (const Token *tok1 = Token::findmatch(_tokenizer->tokens(), "class %var% {"); tok1; tok1 = Token::findmatch(tok1->next(), "class %var% {"))
+    // Function usage, see getFunctionUsage(). It's found when it's needed the first time.
+    bool usageFound = false;
+    std::map<std::string, std::set<std::string> > calledFunctions;
+    std::set<std::string> implemented;
+    std::set<std::string> usedNames;
+
+    const std::vector<ClassModel::Class> &classes = getClassModel().classes;
+    for (std::vector<ClassModel::Class>::const_iterator it = classes.begin(); it != classes.end(); ++it)
     {
+        const Token *tok1 = it->tok;
+        if (tok1->strAt(2)[0] != '{')
+            continue;
+
         /** @todo check that the whole class implementation is seen */
         // until the todo above is fixed we only check classes that are
         // declared in the source file
@@ -493,85 +547,104 @@ void CheckClass::privateFunctions()
             }
         }
 
+        if (FuncList.empty())
+            continue;
+
+        // Find out what functions the member functions use..
+        if (!usageFound)
+        {
+            usageFound = true;
+            getFunctionUsage(calledFunctions, implemented, usedNames);
+        }
+
         // Check that all private functions are used..
-        bool HasFuncImpl = false;
-        bool inclass = false;
-        indent_level = 0;
-        const std::string pattern_function(classname + " ::");
-        for (const Token *ftok = _tokenizer->tokens(); ftok; ftok = ftok->next())
+        if (implemented.find(classname) == implemented.end())
+            continue;
+
+        const std::set<std::string> &called = calledFunctions[classname];
+        for (std::list<const Token *>::const_iterator func = FuncList.begin(); func != FuncList.end(); ++func)
         {
-            if (ftok->str() == "{")
-                ++indent_level;
-            else if (ftok->str() == "}")
-            {
-                if (indent_level > 0)
-                    --indent_level;
-                if (indent_level == 0)
-                    inclass = false;
-            }
+            if (called.find((*func)->str()) != called.end())
+                continue;
 
-            if (Token::Match(ftok, ("class " + classname + " :|{").c_str()))
+            // Final check; check if the function pointer is used somewhere..
+            if (usedNames.find((*func)->str()) == usedNames.end())
             {
-                indent_level = 0;
-                inclass = true;
+                unusedPrivateFunctionError(*func, classname, (*func)->str());
             }
+        }
+    }
+}
 
-            // Check member class functions to see what functions are used..
-            if ((inclass && indent_level == 1 && Token::Match(ftok, ") const| {")) ||
-                (Token::Match(ftok, (classname + " :: ~| %var% (").c_str())))
-            {
-                while (ftok && ftok->str() != ")")
-                    ftok = ftok->next();
-                if (!ftok)
-                    break;
-                if (Token::Match(ftok, ") : %var% ("))
-                {
-                    while (!Token::Match(ftok->next(), "[{};]"))
-                        ftok = ftok->next();
-                }
-                if (!Token::Match(ftok, ") const| {"))
-                    continue;
+void CheckClass::getFunctionUsage(std::map<std::string, std::set<std::string> > &calledFunctions, std::set<std::string> &implemented, std::set<std::string> &usedNames)
+{
+    // The open blocks. The class name is saved for class declarations and
+    // an empty string for other blocks.
+    std::vector<std::string> blocks;
+    std::string classname;
 
-                if (ftok->fileIndex() == 0)
-                    HasFuncImpl = true;
+    for (const Token *tok = _tokenizer->tokens(); tok; tok = tok->next())
+    {
+        if (tok->str() == "{")
+        {
+            blocks.push_back(classname);
+            classname.clear();
+        }
+        else if (tok->str() == "}")
+        {
+            if (!blocks.empty())
+                blocks.pop_back();
+        }
+        else if (Token::Match(tok, "class %var% :|{"))
+            classname = tok->strAt(1);
 
-                // Parse function..
-                int indentlevel2 = 0;
-                for (const Token *tok2 = ftok; tok2; tok2 = tok2->next())
-                {
-                    if (tok2->str() == "{")
-                        ++indentlevel2;
-                    else if (tok2->str() == "}")
-                    {
-                        --indentlevel2;
-                        if (indentlevel2 < 1)
-                            break;
-                    }
-                    else if (Token::Match(tok2, "%var% ("))
-                    {
-                        // Remove function from FuncList
-                        std::list<const Token *>::iterator it = FuncList.begin();
-                        while (it != FuncList.end())
-                        {
-                            if (tok2->str() == (*it)->str())
-                                FuncList.erase(it++);
-                            else
-                                it++;
-                        }
-                    }
-                }
+        // Is the function used as function pointer?
+        if (tok->isName() && Token::Match(tok->previous(), "return|(|)|,|="))
+            usedNames.insert(tok->str());
+
+        // Member function implementation..
+        const Token *ftok = 0;
+        std::string owner;
+        if (!blocks.empty() && !blocks.back().empty() && Token::Match(tok, ") const| {"))
+        {
+            ftok = tok;
+            owner = blocks.back();
+        }
+        else if (Token::Match(tok, "%var% :: ~| %var% ("))
+        {
+            ftok = tok;
+            while (ftok && ftok->str() != ")")
+                ftok = ftok->next();
+            if (Token::Match(ftok, ") : %var% ("))
+            {
+                while (!Token::Match(ftok->next(), "[{};]"))
+                    ftok = ftok->next();
             }
+            if (!Token::Match(ftok, ") const| {"))
+                continue;
+            owner = tok->str();
         }
+        else
+            continue;
+
+        if (ftok->fileIndex() == 0)
+            implemented.insert(owner);
 
-        while (HasFuncImpl && !FuncList.empty())
+        // Parse function..
+        std::set<std::string> &called = calledFunctions[owner];
+        int indentlevel = 0;
+        for (const Token *tok2 = ftok; tok2; tok2 = tok2->next())
         {
-            // Final check; check if the function pointer is used somewhere..
-            const std::string _pattern("return|(|)|,|= " + FuncList.front()->str());
-            if (!Token::findmatch(_tokenizer->tokens(), _pattern.c_str()))
+            if (tok2->str() == "{")
+                ++indentlevel;
+            else if (tok2->str() == "}")
             {
-                unusedPrivateFunctionError(FuncList.front(), classname, FuncList.front()->str());
+                --indentlevel;
+                if (indentlevel < 1)
+                    break;
             }
-            FuncList.pop_front();
+            else if (Token::Match(tok2, "%var% ("))
+                called.insert(tok2->str());
         }
     }
 }
@@ -605,8 +678,7 @@ void CheckClass::noMemset()
             continue;
 
         // Warn if type is a class..
-        const std::string pattern1(std::string("class ") + type);
-        if (Token::findmatch(_tokenizer->tokens(), pattern1.c_str()))
+        if (getClassModel().classNames.find(type) != getClassModel().classNames.end())
         {
             memsetClassError(tok, tok->str());
             continue;
@@ -673,9 +745,8 @@ void CheckClass::virtualDestructor()
     {
         // Check that the derived class has a non empty destructor..
         {
-            std::ostringstream destructorPattern;
-            destructorPattern << "~ " << derived->strAt(1) << " ( ) {";
-            const Token *derived_destructor = Token::findmatch(_tokenizer->tokens(), destructorPattern.str().c_str());
+            std::map<std::string, const Token *>::const_iterator it = getClassModel().destructorImplementations.find(derived->strAt(1));
+            const Token *derived_destructor = (it == getClassModel().destructorImplementations.end()) ? 0 : it->second;
 
             // No destructor..
             if (! derived_destructor)
@@ -719,9 +790,8 @@ void CheckClass::virtualDestructor()
                 continue;
 
             // Find the destructor declaration for the base class.
-            const Token *base = Token::findmatch(_tokenizer->tokens(), (std::string("%any% ~ ") + baseName[0] + " (").c_str());
-            while (base && base->str() == "::")
-                base = Token::findmatch(base->next(), (std::string("%any% ~ ") + baseName[0] + " (").c_str());
+            std::map<std::string, const Token *>::const_iterator it = getClassModel().destructors.find(baseName[0]);
+            const Token *base = (it == getClassModel().destructors.end()) ? 0 : it->second;
 
             const Token *reverseTok = base;
             while (Token::Match(base, "%var%") && base->str() != "virtual")
@@ -731,7 +801,8 @@ void CheckClass::virtualDestructor()
             if (! base)
             {
                 // Is the class declaration available?
-                base = Token::findmatch(_tokenizer->tokens(), (std::string("class ") + baseName[0] + " {").c_str());
+                it = getClassModel().declarations.find(baseName[0]);
+                base = (it == getClassModel().declarations.end()) ? 0 : it->second;
                 if (base)
                 {
                     virtualDestructorError(base, baseName[0], derivedClass->str());
@@ -750,7 +821,7 @@ void CheckClass::virtualDestructor()
             // Proper solution is to check all of the base classes. If base class is not
             // found or if one of the base classes has virtual destructor, error should not
             // be printed. See TODO test case "virtualDestructorInherited"
-            if (!Token::findmatch(_tokenizer->tokens(), (std::string("class ") + baseName[0] + " {").c_str()))
+            if (getClassModel().declarations.find(baseName[0]) == getClassModel().declarations.end())
                 continue;
 
             // Make sure that the destructor is public (protected or private
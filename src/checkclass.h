@@ -23,6 +23,10 @@
 
 #include "check.h"
 #include "settings.h"
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
 
 class Token;
 
@@ -34,12 +38,12 @@ class CheckClass : public Check
 {
 public:
     /** This constructor is used when registering the CheckClass */
-    CheckClass() : Check()
+    CheckClass() : Check(), _classModelCreated(false)
     { }
 
     /** This constructor is used when running checks.. */
     CheckClass(const Tokenizer *tokenizer, const Settings *settings, ErrorLogger *errorLogger)
-            : Check(tokenizer, settings, errorLogger)
+            : Check(tokenizer, settings, errorLogger), _classModelCreated(false)
     { }
 
     void runChecks(const Tokenizer *tokenizer, const Settings *settings, ErrorLogger *errorLogger)
@@ -83,21 +87,85 @@ private:
     class Var
     {
     public:
-        Var(const char *name = 0, bool init = false, Var *next = 0)
+        Var(const char *name = 0, bool init = false)
         {
             this->name = name;
             this->init = init;
-            this->next = next;
         }
 
         const char *name;
         bool        init;
-        Var *next;
     };
 
-    void initializeVarList(const Token *tok1, const Token *ftok, Var *varlist, const char classname[], std::list<std::string> &callstack);
-    void initVar(Var *varlist, const char varname[]);
-    Var *getVarList(const Token *tok1, bool withClasses);
+    /**
+     * Information about the classes in the token list. It is collected
+     * by getClassModel() and shared by all the checks of this object.
+     */
+    class ClassModel
+    {
+    public:
+        /** A class declaration "class %var% [{:]" */
+        class Class
+        {
+        public:
+            Class(const Token *tok) : tok(tok), hasConstructor(false)
+            { }
+
+            /** the "class" token */
+            const Token *tok;
+
+            /** is there a "%any% classname (" after the declaration that is not a destructor */
+            bool hasConstructor;
+        };
+
+        /** The class declarations in the order they are found */
+        std::vector<Class> classes;
+
+        /** Names that follow "class" anywhere in the token list */
+        std::set<std::string> classNames;
+
+        /** The first "class %var% {" of each class name */
+        std::map<std::string, const Token *> declarations;
+
+        /** Names that follow "enum" */
+        std::set<std::string> enums;
+
+        /** Static member variables that are given a value: "classname :: varname =" */
+        std::set<std::pair<std::string, std::string> > staticMembers;
+
+        /** The first destructor "%any% ~ classname (" that is not "::" */
+        std::map<std::string, const Token *> destructors;
+
+        /** The first destructor implementation "~ classname ( ) {" */
+        std::map<std::string, const Token *> destructorImplementations;
+
+        /** Member variables, see getVarList(). The key is the class token and withClasses */
+        std::map<std::pair<const Token *, bool>, std::vector<Var> > varlists;
+
+        /** Member functions, see findClassFunction(). The key is the class token and the function name */
+        std::map<std::pair<const Token *, std::string>, const Token *> functions;
+    };
+
+    /** Get the class model. It is created the first time this is called. */
+    ClassModel &getClassModel();
+
+    bool _classModelCreated;
+    ClassModel _classModel;
+
+    void initializeVarList(const Token *tok1, const Token *ftok, std::vector<Var> &varlist, const char classname[], std::set<std::string> &callstack);
+    void initVar(std::vector<Var> &varlist, const char varname[]);
+    const std::vector<Var> &getVarList(const Token *tok1, bool withClasses);
+
+    /** Find the first implementation of a member function, see Tokenizer::findClassFunction */
+    const Token *findClassFunction(const Token *tok1, const std::string &funcname);
+
+    /**
+     * Find out what functions are used by the member functions of the classes
+     * @param calledFunctions for each class name, the functions that its member functions call
+     * @param implemented classes that have member functions in the source file
+     * @param usedNames names that follow "return|(|)|,|=", e.g. function pointers
+     */
+    void getFunctionUsage(std::map<std::string, std::set<std::string> > &calledFunctions, std::set<std::string> &implemented, std::set<std::string> &usedNames);
 
     // Check constructors for a specified class
     void checkConstructors(const Token *tok1, const char funcname[]);
@@ -33,20 +33,33 @@ CheckDangerousFunctions instance;
 
 void CheckDangerousFunctions::dangerousFunctions()
 {
-    for (const Token *tok = _tokenizer->tokens(); tok; tok = tok->next())
+    TokenMatcher matcher;
+    addPatterns(matcher);
+    matcher.run(_tokenizer->tokens());
+}
+
+void CheckDangerousFunctions::addPatterns(TokenMatcher &matcher)
+{
+    matcher.addPattern("mktemp (", this, MKTEMP);
+    matcher.addPattern("gets (", this, GETS);
+    matcher.addPattern("scanf (", this, SCANF);
+}
+
+void CheckDangerousFunctions::patternMatch(const Token *tok, unsigned int id)
+{
+    switch (id)
     {
-        if (Token::simpleMatch(tok, "mktemp ("))
-        {
-            dangerousFunctionmktemp(tok);
-        }
-        else if (Token::simpleMatch(tok, "gets ("))
-        {
-            dangerousFunctiongets(tok);
-        }
-        else if (Token::simpleMatch(tok, "scanf ("))
-        {
-            dangerousFunctionscanf(tok);
-        }
+    case MKTEMP:
+        dangerousFunctionmktemp(tok);
+        break;
+
+    case GETS:
+        dangerousFunctiongets(tok);
+        break;
+
+    case SCANF:
+        dangerousFunctionscanf(tok);
+        break;
     }
 }
 //---------------------------------------------------------------------------
@@ -39,19 +39,29 @@ public:
             : Check(tokenizer, settings, errorLogger)
     { }
 
-    void runSimplifiedChecks(const Tokenizer *tokenizer, const Settings *settings, ErrorLogger *errorLogger)
+    void runSimplifiedChecks(const Tokenizer *, const Settings *, ErrorLogger *)
     {
-        CheckDangerousFunctions checkDangerousFunctions(tokenizer, settings, errorLogger);
-        if (settings->_checkCodingStyle)
-        {
-            checkDangerousFunctions.dangerousFunctions();
-        }
+        // The dangerous functions are found through the TokenMatcher
     }
 
+    Check *createMatcherCheck(const Tokenizer *tokenizer, const Settings *settings, ErrorLogger *errorLogger)
+    {
+        if (!settings->_checkCodingStyle)
+            return 0;
+        return new CheckDangerousFunctions(tokenizer, settings, errorLogger);
+    }
+
+    void addPatterns(TokenMatcher &matcher);
+
+    void patternMatch(const Token *tok, unsigned int id);
+
     /** Check for dangerous functions */
     void dangerousFunctions();
 
 private:
+    /** ids of the patterns */
+    enum Pattern { MKTEMP, GETS, SCANF };
+
     /** Error Messages.. */
     void dangerousFunctionmktemp(const Token *tok);
     void dangerousFunctiongets(const Token *tok);
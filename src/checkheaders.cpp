@@ -23,10 +23,11 @@
 #include "filelister.h"
 #include "token.h"
 
-#include <algorithm>
-#include <list>
+#include <map>
+#include <set>
 #include <sstream>
 #include <string>
+#include <vector>
 #include <cstring>
 //---------------------------------------------------------------------------
 
@@ -87,160 +88,231 @@ void CheckHeaders::warningHeaderWithImplementation()
 // HEADERS - Unneeded include
 //---------------------------------------------------------------------------
 
-void CheckHeaders::warningIncludeHeader()
+namespace
 {
-    // Including..
-    for (const Token *includetok = _tokenizer->tokens(); includetok; includetok = includetok->next())
-    {
-        if (includetok->str() != "#include")
-            continue;
+/** The classes and names that are declared in a header */
+struct Declarations
+{
+    std::set<std::string> classes;
+    std::set<std::string> names;
+};
 
-        // Get fileindex of included file..
-        unsigned int hfile = 0;
-        const char *includefile = includetok->strAt(1);
-        while (hfile < _tokenizer->getFiles()->size())
-        {
-            if (FileLister::sameFileName(_tokenizer->getFiles()->at(hfile).c_str(), includefile))
-                break;
-            ++hfile;
-        }
-        if (hfile == _tokenizer->getFiles()->size())
-            continue;
+/** The names that are used in a file */
+struct Usage
+{
+    /** All names */
+    std::set<std::string> names;
 
-        // This header is needed if:
-        // * It contains some needed class declaration
-        // * It contains some needed function declaration
-        // * It contains some needed constant value
-        // * It contains some needed variable
-        // * It contains some needed enum
+    /** The names in ": %var% {" and ": %type% %var% {" */
+    std::set<std::string> baseClasses;
+};
+}
 
-        std::list<std::string> classlist;
-        std::list<std::string> namelist;
+/**
+ * Extract classes and names in the header..
+ * @param tokens the tokens of the header, in the order of the token list
+ * @param hfile the file index of the header
+ * @param declarations the declared classes and names are added here
+ */
+static void getDeclarations(const std::vector<const Token *> &tokens, unsigned int hfile, Declarations &declarations)
+{
+    std::set<std::string> &classlist = declarations.classes;
+    std::set<std::string> &namelist = declarations.names;
 
-        // Extract classes and names in the header..
-        int indentlevel = 0;
-        for (const Token *tok1 = _tokenizer->tokens(); tok1; tok1 = tok1->next())
-        {
-            if (tok1->fileIndex() != hfile)
-                continue;
+    int indentlevel = 0;
+    for (unsigned int i = 0; i < tokens.size(); ++i)
+    {
+        const Token *tok1 = tokens[i];
 
-            // I'm only interested in stuff that is declared at indentlevel 0
-            if (tok1->str() == "{")
-                ++indentlevel;
+        // I'm only interested in stuff that is declared at indentlevel 0
+        if (tok1->str() == "{")
+            ++indentlevel;
 
-            else if (tok1->str() == "}")
-                --indentlevel;
+        else if (tok1->str() == "}")
+            --indentlevel;
 
-            if (indentlevel != 0)
-                continue;
+        if (indentlevel != 0)
+            continue;
 
-            // Class or namespace declaration..
-            // --------------------------------------
-            if (Token::Match(tok1, "class %var% {") || Token::Match(tok1, "class %var% :") || Token::Match(tok1, "namespace %var% {"))
-                classlist.push_back(tok1->strAt(1));
+        // Class or namespace declaration..
+        // --------------------------------------
+        if (Token::Match(tok1, "class %var% {") || Token::Match(tok1, "class %var% :") || Token::Match(tok1, "namespace %var% {"))
+            classlist.insert(tok1->strAt(1));
 
-            // Variable declaration..
-            // --------------------------------------
-            else if (Token::Match(tok1, "%type% %var% ;") || Token::Match(tok1, "%type% %var% ["))
-                namelist.push_back(tok1->strAt(1));
+        // Variable declaration..
+        // --------------------------------------
+        else if (Token::Match(tok1, "%type% %var% ;") || Token::Match(tok1, "%type% %var% ["))
+            namelist.insert(tok1->strAt(1));
 
-            else if (Token::Match(tok1, "%type% * %var% ;") || Token::Match(tok1, "%type% * %var% ["))
-                namelist.push_back(tok1->strAt(2));
+        else if (Token::Match(tok1, "%type% * %var% ;") || Token::Match(tok1, "%type% * %var% ["))
+            namelist.insert(tok1->strAt(2));
 
-            else if (Token::Match(tok1, "const %type% %var% =") || Token::Match(tok1, "const %type% %var% ["))
-                namelist.push_back(tok1->strAt(2));
+        else if (Token::Match(tok1, "const %type% %var% =") || Token::Match(tok1, "const %type% %var% ["))
+            namelist.insert(tok1->strAt(2));
 
-            else if (Token::Match(tok1, "const %type% * %var% =") || Token::Match(tok1, "const %type% * %var% ["))
-                namelist.push_back(tok1->strAt(3));
+        else if (Token::Match(tok1, "const %type% * %var% =") || Token::Match(tok1, "const %type% * %var% ["))
+            namelist.insert(tok1->strAt(3));
 
-            // enum..
-            // --------------------------------------
-            else if (tok1->str() == "enum")
+        // enum..
+        // --------------------------------------
+        else if (tok1->str() == "enum")
+        {
+            tok1 = tok1->next();
+            if (tok1->fileIndex() == hfile)
+                ++i;
+            while (! Token::Match(tok1, "; %any%"))
             {
+                if (tok1->isName())
+                    namelist.insert(tok1->str());
                 tok1 = tok1->next();
-                while (! Token::Match(tok1, "; %any%"))
-                {
-                    if (tok1->isName())
-                        namelist.push_back(tok1->str());
-                    tok1 = tok1->next();
-                }
+                if (tok1->fileIndex() == hfile)
+                    ++i;
             }
+        }
 
-            // function..
-            // --------------------------------------
-            else if (Token::Match(tok1, "%type% %var% ("))
-                namelist.push_back(tok1->strAt(1));
+        // function..
+        // --------------------------------------
+        else if (Token::Match(tok1, "%type% %var% ("))
+            namelist.insert(tok1->strAt(1));
 
-            else if (Token::Match(tok1, "%type% * %var% ("))
-                namelist.push_back(tok1->strAt(2));
+        else if (Token::Match(tok1, "%type% * %var% ("))
+            namelist.insert(tok1->strAt(2));
 
-            else if (Token::Match(tok1, "const %type% %var% ("))
-                namelist.push_back(tok1->strAt(2));
+        else if (Token::Match(tok1, "const %type% %var% ("))
+            namelist.insert(tok1->strAt(2));
 
-            else if (Token::Match(tok1, "const %type% * %var% ("))
-                namelist.push_back(tok1->strAt(3));
+        else if (Token::Match(tok1, "const %type% * %var% ("))
+            namelist.insert(tok1->strAt(3));
 
-            // typedef..
-            // --------------------------------------
-            else if (tok1->str() == "typedef")
+        // typedef..
+        // --------------------------------------
+        else if (tok1->str() == "typedef")
+        {
+            if (strcmp(tok1->strAt(1), "enum") == 0)
+                continue;
+            int parlevel = 0;
+            while (tok1->next())
             {
-                if (strcmp(tok1->strAt(1), "enum") == 0)
-                    continue;
-                int parlevel = 0;
-                while (tok1->next())
-                {
-                    if (Token::Match(tok1, "[({]"))
-                        ++parlevel;
+                if (Token::Match(tok1, "[({]"))
+                    ++parlevel;
 
-                    else if (Token::Match(tok1, "[)}]"))
-                        --parlevel;
+                else if (Token::Match(tok1, "[)}]"))
+                    --parlevel;
 
-                    else if (parlevel == 0)
-                    {
-                        if (tok1->str() == ";")
-                            break;
-
-                        if (Token::Match(tok1, "%var% ;"))
-                            namelist.push_back(tok1->str());
-                    }
+                else if (parlevel == 0)
+                {
+                    if (tok1->str() == ";")
+                        break;
 
-                    tok1 = tok1->next();
+                    if (Token::Match(tok1, "%var% ;"))
+                        namelist.insert(tok1->str());
                 }
+
+                tok1 = tok1->next();
+                if (tok1->fileIndex() == hfile)
+                    ++i;
             }
         }
+    }
+}
 
+/**
+ * Extract the names that are used in a file
+ * @param tokens the tokens of the file
+ * @param usage the used names are added here
+ */
+static void getUsage(const std::vector<const Token *> &tokens, Usage &usage)
+{
+    for (std::vector<const Token *>::const_iterator it = tokens.begin(); it != tokens.end(); ++it)
+    {
+        const Token *tok1 = *it;
 
-        // Check if the extracted names are used...
-        bool Needed = false;
-        bool NeedDeclaration = false;
-        for (const Token *tok1 = _tokenizer->tokens(); tok1; tok1 = tok1->next())
-        {
-            if (tok1->fileIndex() != includetok->fileIndex())
-                continue;
+        if (Token::Match(tok1, ": %var% {") || Token::Match(tok1, ": %type% %var% {"))
+            usage.baseClasses.insert(tok1->strAt((strcmp(tok1->strAt(2), "{")) ? 2 : 1));
+
+        if (tok1->isName())
+            usage.names.insert(tok1->str());
+    }
+}
+
+/** Is any of the names in the first set also in the second set? */
+static bool intersects(const std::set<std::string> &names1, const std::set<std::string> &names2)
+{
+    std::set<std::string>::const_iterator it1 = names1.begin();
+    std::set<std::string>::const_iterator it2 = names2.begin();
+    while (it1 != names1.end() && it2 != names2.end())
+    {
+        if (*it1 < *it2)
+            ++it1;
+        else if (*it2 < *it1)
+            ++it2;
+        else
+            return true;
+    }
+    return false;
+}
+
+void CheckHeaders::warningIncludeHeader()
+{
+    const std::vector<std::string> &files = *_tokenizer->getFiles();
+
+    // The tokens of each file, so that the token list is scanned only once
+    std::vector< std::vector<const Token *> > fileTokens(files.size());
+    for (const Token *tok = _tokenizer->tokens(); tok; tok = tok->next())
+    {
+        if (tok->fileIndex() < fileTokens.size())
+            fileTokens[tok->fileIndex()].push_back(tok);
+    }
+
+    // The file indexes of the included files, the declarations in the
+    // headers and the names used in the files are looked up only once
+    std::map<std::string, unsigned int> fileIndexes;
+    std::map<unsigned int, Declarations> declarations;
+    std::map<unsigned int, Usage> usages;
+
+    // Including..
+    for (const Token *includetok = _tokenizer->tokens(); includetok; includetok = includetok->next())
+    {
+        if (includetok->str() != "#include")
+            continue;
 
-            if (Token::Match(tok1, ": %var% {") || Token::Match(tok1, ": %type% %var% {"))
+        // Get fileindex of included file..
+        const char *includefile = includetok->strAt(1);
+        std::map<std::string, unsigned int>::const_iterator fileIndex = fileIndexes.find(includefile);
+        if (fileIndex == fileIndexes.end())
+        {
+            unsigned int hfile = 0;
+            while (hfile < files.size())
             {
-                std::string classname = tok1->strAt((strcmp(tok1->strAt(2), "{")) ? 2 : 1);
-                if (std::find(classlist.begin(), classlist.end(), classname) != classlist.end())
-                {
-                    Needed = true;
+                if (FileLister::sameFileName(files[hfile].c_str(), includefile))
                     break;
-                }
+                ++hfile;
             }
+            fileIndex = fileIndexes.insert(std::make_pair(std::string(includefile), hfile)).first;
+        }
+        const unsigned int hfile = fileIndex->second;
+        if (hfile == files.size())
+            continue;
 
-            if (! tok1->isName())
-                continue;
+        // This header is needed if:
+        // * It contains some needed class declaration
+        // * It contains some needed function declaration
+        // * It contains some needed constant value
+        // * It contains some needed variable
+        // * It contains some needed enum
 
-            if (std::find(namelist.begin(), namelist.end(), tok1->str().c_str()) != namelist.end())
-            {
-                Needed = true;
-                break;
-            }
+        if (declarations.find(hfile) == declarations.end())
+            getDeclarations(fileTokens[hfile], hfile, declarations[hfile]);
+        const Declarations &declared = declarations[hfile];
 
-            if (! NeedDeclaration)
-                NeedDeclaration = (std::find(classlist.begin(), classlist.end(), tok1->str().c_str()) != classlist.end());
-        }
+        if (usages.find(includetok->fileIndex()) == usages.end())
+            getUsage(fileTokens[includetok->fileIndex()], usages[includetok->fileIndex()]);
+        const Usage &used = usages[includetok->fileIndex()];
 
+        // Check if the extracted names are used...
+        bool Needed = intersects(declared.classes, used.baseClasses) ||
+                      intersects(declared.names, used.names);
+        const bool NeedDeclaration = intersects(declared.classes, used.names);
 
         // Not a header file?
         if (includetok->fileIndex() == 0)
@@ -264,6 +336,3 @@ void CheckHeaders::warningIncludeHeader()
     }
 }
 //---------------------------------------------------------------------------
-
-
-
@@ -159,6 +159,10 @@ CheckMemoryLeak::AllocType CheckMemoryLeak::getReallocationType(const Token *tok
 
 CheckMemoryLeak::AllocType CheckMemoryLeak::getDeallocationType(const Token *tok, const char *varnames[])
 {
+    // Bail out quickly if this is not a deallocation
+    if (!Token::Match(tok, "delete|free|kfree|g_free|fclose|fcloseall|close|pclose|closedir"))
+        return No;
+
     int i = 0;
     std::string names;
     while (varnames[i])
@@ -291,6 +295,17 @@ void CheckMemoryLeak::mismatchAllocDealloc(const std::list<const Token *> &calls
 }
 
 CheckMemoryLeak::AllocType CheckMemoryLeak::functionReturnType(const Token *tok) const
+{
+    std::map<const Token *, AllocType>::const_iterator it = _functionReturnTypes.find(tok);
+    if (it != _functionReturnTypes.end())
+        return it->second;
+
+    const AllocType allocType = findFunctionReturnType(tok);
+    _functionReturnTypes[tok] = allocType;
+    return allocType;
+}
+
+CheckMemoryLeak::AllocType CheckMemoryLeak::findFunctionReturnType(const Token *tok) const
 {
     // Locate the start of the function..
     unsigned int parlevel = 0;
@@ -477,6 +492,10 @@ const char * CheckMemoryLeakInFunction::call_func(const Token *tok, std::list<co
         AllocType a = functionReturnType(ftok);
         if (a != No)
             return "alloc";
+
+        // A function in another file..
+        if (!ftok && _settings->_allocFunctions.find(funcname) != _settings->_allocFunctions.end())
+            return "alloc";
     }
 
     // how many parameters is there in the function call?
@@ -518,7 +537,22 @@ const char * CheckMemoryLeakInFunction::call_func(const Token *tok, std::list<co
             {
                 const Token *ftok = _tokenizer->getFunctionTokenByName(funcname.c_str());
                 if (!ftok)
-                    return "use";
+                {
+                    // Does a function in another file deallocate the variable?
+                    std::map<std::pair<std::string, unsigned int>, int>::const_iterator it;
+                    it = _settings->_deallocFunctions.find(std::make_pair(funcname, static_cast<unsigned int>(par)));
+                    if (it == _settings->_deallocFunctions.end())
+                        return "use";
+
+                    Event event;
+                    event.type = Event::DEALLOC;
+                    event.alloc = static_cast<AllocType>(it->second);
+                    event.tok = callstack.back();
+                    event.varname = varnames[0];
+                    callstack.pop_back();
+                    handleEvent(event, callstack, alloctype, dealloctype, sz);
+                    return "dealloc";
+                }
 
                 // how many parameters does the function want?
                 if (numpar != countParameters(ftok))
@@ -527,11 +561,37 @@ const char * CheckMemoryLeakInFunction::call_func(const Token *tok, std::list<co
                 const char *parname = Tokenizer::getParameterName(ftok, par);
                 if (! parname)
                     return "recursive";
+                // Has the function been analysed already?
+                std::ostringstream key;
+                for (std::list<const Token *>::const_iterator it = callstack.begin(); it != callstack.end(); ++it)
+                    key << (*it)->str() << " ";
+                key << par;
+
+                std::map<std::string, FunctionSummary>::const_iterator it = _functionSummaries.find(key.str());
+                if (it != _functionSummaries.end())
+                {
+                    const FunctionSummary &summary = it->second;
+                    for (std::list<Event>::const_iterator event = summary.events.begin(); event != summary.events.end(); ++event)
+                    {
+                        std::list<const Token *> eventCallstack(callstack);
+                        eventCallstack.insert(eventCallstack.end(), event->callstack.begin(), event->callstack.end());
+                        handleEvent(*event, eventCallstack, alloctype, dealloctype, sz);
+                    }
+                    if (summary.all)
+                        all = true;
+                    return summary.ret;
+                }
+
+                FunctionSummary &summary = _functionSummaries[key.str()];
+                summary.ret = 0;
+                summary.all = false;
+                _summaryRecorders.push_back(std::make_pair(&summary, static_cast<unsigned int>(callstack.size())));
+
                 // Check if the function deallocates the variable..
                 while (ftok && (ftok->str() != "{"))
                     ftok = ftok->next();
-                Token *func = getcode(ftok->tokAt(1), callstack, parname, alloctype, dealloctype, false, all, sz);
-                simplifycode(func, all);
+                Token *func = getcode(ftok->tokAt(1), callstack, parname, alloctype, dealloctype, false, summary.all, sz);
+                simplifycode(func, summary.all);
                 const Token *func_ = func;
                 while (func_ && func_->str() == ";")
                     func_ = func_->next();
@@ -546,6 +606,11 @@ const char * CheckMemoryLeakInFunction::call_func(const Token *tok, std::list<co
                     ret = "&use";
 
                 Tokenizer::deleteTokens(func);
+
+                summary.ret = ret;
+                _summaryRecorders.pop_back();
+                if (summary.all)
+                    all = true;
                 return ret;
             }
         }
@@ -584,6 +649,14 @@ Token *CheckMemoryLeakInFunction::getcode(const Token *tok, std::list<const Toke
     // The first token should be ";"
     addtoken(";");
 
+    // The patterns that are matched at every token
+    const std::string assignUsePattern1("[)=] " + varnameStr + " [+;)]");
+    const std::string assignUsePattern2(varnameStr + " +=|-=");
+    const std::string assignUsePattern3("+=|<< " + varnameStr + " ;");
+    const std::string assignUsePattern4("= strcpy|strcat|memmove|memcpy ( " + varnameStr + " ,");
+    const std::string useIndexPattern("[;{}=(,+-*/] " + varnameStr + " [");
+    const std::string addressPattern("[=(,] & " + varnameStr + " [.[,)]");
+
     bool isloop = false;
 
     int indentlevel = 0;
@@ -612,16 +685,17 @@ Token *CheckMemoryLeakInFunction::getcode(const Token *tok, std::list<const Toke
         if (parlevel == 0 && tok->str() == ";")
             addtoken(";");
 
-        if (Token::Match(tok->previous(), std::string("[(;{}] " + varnameStr + " =").c_str()))
+        if (tok->str() == varnameStr && Token::Match(tok->previous(), "[(;{}] %var% ="))
         {
             AllocType alloc = getAllocationType(tok->tokAt(2));
             bool realloc = false;
 
-            if (sz > 1 &&
-                Token::Match(tok->tokAt(2), "malloc ( %num% )") &&
-                (MathLib::toLongNumber(tok->strAt(4)) % sz) != 0)
+            if (Token::Match(tok->tokAt(2), "malloc ( %num% )"))
             {
-                mismatchSizeError(tok->tokAt(4), tok->strAt(4));
+                Event event;
+                event.type = Event::SIZE;
+                event.tok = tok->tokAt(4);
+                handleEvent(event, callstack, alloctype, dealloctype, sz);
             }
 
             if (alloc == No)
@@ -647,7 +721,7 @@ Token *CheckMemoryLeakInFunction::getcode(const Token *tok, std::list<const Toke
                         if (_settings->_showAll)
                         {
 
-                            if (_settings->isAutoDealloc(tok->strAt(3)))
+                            if (_settings->isAutoDealloc(tok->tokAt(3)->str()))
                             {
                                 // This class has automatic deallocation
                                 alloc = No;
@@ -669,17 +743,12 @@ Token *CheckMemoryLeakInFunction::getcode(const Token *tok, std::list<const Toke
                 if (! realloc)
                     addtoken("alloc");
 
-                if (alloctype != No && alloctype != alloc)
-                    alloc = Many;
-
-                if (alloc != Many && dealloctype != No && dealloctype != Many && dealloctype != alloc)
-                {
-                    callstack.push_back(tok);
-                    mismatchAllocDealloc(callstack, varname);
-                    callstack.pop_back();
-                }
-
-                alloctype = alloc;
+                Event event;
+                event.type = Event::ALLOC;
+                event.alloc = alloc;
+                event.tok = tok;
+                event.varname = varnameStr;
+                handleEvent(event, callstack, alloctype, dealloctype, sz);
             }
 
             else if (matchFunctionsThatReturnArg(tok->previous(), std::string(varname)))
@@ -716,16 +785,12 @@ Token *CheckMemoryLeakInFunction::getcode(const Token *tok, std::list<const Toke
             {
                 addtoken("dealloc");
 
-                if (dealloctype != No && dealloctype != dealloc)
-                    dealloc = Many;
-
-                if (dealloc != Many && alloctype != No && alloctype != Many && alloctype != dealloc)
-                {
-                    callstack.push_back(tok);
-                    mismatchAllocDealloc(callstack, varname);
-                    callstack.pop_back();
-                }
-                dealloctype = dealloc;
+                Event event;
+                event.type = Event::DEALLOC;
+                event.alloc = dealloc;
+                event.tok = tok;
+                event.varname = varnameStr;
+                handleEvent(event, callstack, alloctype, dealloctype, sz);
                 continue;
             }
         }
@@ -756,6 +821,8 @@ Token *CheckMemoryLeakInFunction::getcode(const Token *tok, std::list<const Toke
                 // Check if the condition depends on var somehow..
                 bool dep = false;
                 int parlevel = 0;
+                const std::string closePattern("close|fclose|closedir ( " + varnameStr + " )");
+                const std::string memberPattern(varnameStr + " .");
                 for (const Token *tok2 = tok; tok2; tok2 = tok2->next())
                 {
                     if (tok2->str() == "(")
@@ -766,7 +833,7 @@ Token *CheckMemoryLeakInFunction::getcode(const Token *tok, std::list<const Toke
                         if (parlevel <= 0)
                             break;
                     }
-                    if (Token::Match(tok2, std::string("close|fclose|closedir ( " + varnameStr + " )").c_str()))
+                    if (Token::Match(tok2, closePattern.c_str()))
                     {
                         addtoken("dealloc");
                         addtoken(";");
@@ -775,7 +842,7 @@ Token *CheckMemoryLeakInFunction::getcode(const Token *tok, std::list<const Toke
                     }
                     if ((tok2->str() != ".") &&
                         Token::simpleMatch(tok2->next(), varnameStr.c_str()) &&
-                        !Token::simpleMatch(tok2->next(), std::string(varnameStr + " .").c_str()))
+                        !Token::simpleMatch(tok2->next(), memberPattern.c_str()))
                     {
                         dep = true;
                         break;
@@ -898,14 +965,14 @@ Token *CheckMemoryLeakInFunction::getcode(const Token *tok, std::list<const Toke
         }
 
         // Assignment..
-        if (Token::Match(tok, std::string("[)=] " + varnameStr + " [+;)]").c_str()) ||
-            Token::Match(tok, std::string(varnameStr + " +=|-=").c_str()) ||
-            Token::Match(tok, std::string("+=|<< " + varnameStr + " ;").c_str()) ||
-            Token::Match(tok, std::string("= strcpy|strcat|memmove|memcpy ( " + varnameStr + " ,").c_str()))
+        if (Token::Match(tok, assignUsePattern1.c_str()) ||
+            Token::Match(tok, assignUsePattern2.c_str()) ||
+            Token::Match(tok, assignUsePattern3.c_str()) ||
+            Token::Match(tok, assignUsePattern4.c_str()))
         {
             addtoken("use");
         }
-        else if (Token::Match(tok->previous(), std::string("[;{}=(,+-*/] " + varnameStr + " [").c_str()))
+        else if (Token::Match(tok->previous(), useIndexPattern.c_str()))
         {
             addtoken("use_");
         }
@@ -988,7 +1055,7 @@ Token *CheckMemoryLeakInFunction::getcode(const Token *tok, std::list<const Toke
         }
 
         // Linux lists..
-        if (Token::Match(tok, std::string("[=(,] & " + varnameStr + " [.[,)]").c_str()))
+        if (Token::Match(tok, addressPattern.c_str()))
         {
             addtoken("&use");
         }
@@ -1002,6 +1069,44 @@ Token *CheckMemoryLeakInFunction::getcode(const Token *tok, std::list<const Toke
 
 
 
+void CheckMemoryLeakInFunction::handleEvent(const Event &event, const std::list<const Token *> &callstack, AllocType &alloctype, AllocType &dealloctype, unsigned int sz)
+{
+    // Record the event in the summaries that are being created. Only the
+    // part of the callstack that is below the summarized function is saved.
+    for (std::list<std::pair<FunctionSummary *, unsigned int> >::iterator it = _summaryRecorders.begin(); it != _summaryRecorders.end(); ++it)
+    {
+        std::list<const Token *>::const_iterator tok = callstack.begin();
+        for (unsigned int i = 0; i < it->second && tok != callstack.end(); ++i)
+            ++tok;
+
+        it->first->events.push_back(event);
+        it->first->events.back().callstack.assign(tok, callstack.end());
+    }
+
+    if (event.type == Event::SIZE)
+    {
+        if (sz > 1 && (MathLib::toLongNumber(event.tok->str()) % sz) != 0)
+            mismatchSizeError(event.tok, event.tok->str());
+        return;
+    }
+
+    AllocType &type = (event.type == Event::ALLOC) ? alloctype : dealloctype;
+    const AllocType other = (event.type == Event::ALLOC) ? dealloctype : alloctype;
+
+    AllocType alloc = event.alloc;
+    if (type != No && type != alloc)
+        alloc = Many;
+
+    if (alloc != Many && other != No && other != Many && other != alloc)
+    {
+        std::list<const Token *> mismatchCallstack(callstack);
+        mismatchCallstack.push_back(event.tok);
+        mismatchAllocDealloc(mismatchCallstack, event.varname);
+    }
+
+    type = alloc;
+}
+
 void CheckMemoryLeakInFunction::simplifycode(Token *tok, bool &all)
 {
     // Replace "throw" that is not in a try block with "return"
@@ -1660,12 +1765,147 @@ void CheckMemoryLeakInFunction::checkScope(const Token *Tok1, const char varname
 // Checks for memory leaks inside function..
 //---------------------------------------------------------------------------
 
+bool CheckMemoryLeakInFunction::getAllocatedVariables(const Token *tok, std::set<std::string> &varnames)
+{
+    const Token * const end = tok->link();
+
+    // No variable is named in a deallocation such as "fcloseall ( )"
+    static const char *noVarnames[] = { 0 };
+
+    for (; tok && tok != end; tok = tok->next())
+    {
+        if (Token::Match(tok, "%var% ="))
+        {
+            // Is there a function call or "new" in the assigned value?
+            for (const Token *tok2 = tok->tokAt(2); tok2 && tok2->str() != ";"; tok2 = tok2->next())
+            {
+                if (tok2->str() == "(" || tok2->str() == "new")
+                {
+                    varnames.insert(tok->str());
+                    break;
+                }
+            }
+        }
+
+        else if (Token::Match(tok, "[(,] %var% [,)]"))
+            varnames.insert(tok->strAt(1));
+
+        else if (Token::Match(tok, "delete %var%"))
+            varnames.insert(tok->strAt(1));
+
+        else if (Token::Match(tok, "delete [ ] %var%"))
+            varnames.insert(tok->strAt(3));
+
+        // A deallocation that doesn't name the variable can deallocate
+        // any variable => all variables must be checked
+        else if (Token::Match(tok, "%var% ( )") && getDeallocationType(tok, noVarnames) != No)
+            return true;
+    }
+
+    return false;
+}
+
+void CheckMemoryLeakInFunction::summary(std::ostream &ostr)
+{
+    int indentlevel = 0;
+    for (const Token *tok = _tokenizer->tokens(); tok; tok = tok->next())
+    {
+        if (tok->str() == "{")
+            ++indentlevel;
+        else if (tok->str() == "}")
+            --indentlevel;
+
+        if (indentlevel > 0 || !Token::Match(tok, "%var% (") || !tok->next()->link())
+            continue;
+
+        // Only the functions that can be called from other files..
+        if (Token::simpleMatch(tok->previous(), "::"))
+            continue;
+        bool isStatic = false;
+        for (const Token *tok2 = tok->previous(); tok2 && !Token::Match(tok2, "[;{}]"); tok2 = tok2->previous())
+            isStatic |= (tok2->str() == "static");
+        if (isStatic)
+            continue;
+
+        const Token *body = tok->next()->link()->next();
+        if (body && body->str() == "const")
+            body = body->next();
+        if (!body || body->str() != "{")
+            continue;
+
+        const std::string funcname(tok->str());
+
+        const AllocType allocType = functionReturnType(tok);
+        if (allocType != No)
+            ostr << "alloc " << funcname << " " << allocType << "\n";
+
+        // Check what the function does with each parameter, the same way
+        // call_func does it.
+        const int numpar = countParameters(tok);
+        for (int par = 1; par <= numpar; ++par)
+        {
+            const char *parname = Tokenizer::getParameterName(tok, par);
+            if (!parname)
+                continue;
+
+            std::list<const Token *> callstack;
+            callstack.push_back(tok);
+            AllocType alloctype = No;
+            AllocType dealloctype = No;
+            bool all = false;
+            Token *func = getcode(body->next(), callstack, parname, alloctype, dealloctype, false, all, 1);
+            simplifycode(func, all);
+
+            if (dealloctype != No && Token::findmatch(func, "dealloc"))
+                ostr << "dealloc " << funcname << " " << par << " " << dealloctype << "\n";
+
+            Tokenizer::deleteTokens(func);
+        }
+
+        tok = body->link();
+        if (!tok)
+            break;
+    }
+}
+
+void CheckMemoryLeakInFunction::readSummary(std::istream &istr, Settings &settings)
+{
+    std::string line;
+    while (std::getline(istr, line))
+    {
+        std::istringstream iss(line);
+        std::string keyword, funcname;
+        iss >> keyword >> funcname;
+
+        if (keyword == "alloc")
+        {
+            int allocType = No;
+            if (iss >> allocType)
+                settings._allocFunctions.insert(std::make_pair(funcname, allocType));
+        }
+
+        else if (keyword == "dealloc")
+        {
+            unsigned int par = 0;
+            int deallocType = No;
+            if (iss >> par >> deallocType)
+                settings._deallocFunctions.insert(std::make_pair(std::make_pair(funcname, par), deallocType));
+        }
+    }
+}
+
 void CheckMemoryLeakInFunction::check()
 {
     bool classmember = false;
     bool beforeParameters = false;
     bool infunc = false;
     int indentlevel = 0;
+
+    // The variables in the current function that must be checked, or
+    // all variables, see getAllocatedVariables()
+    std::set<std::string> varnames;
+    bool allVariables = false;
+
     for (const Token *tok = _tokenizer->tokens(); tok; tok = tok->next())
     {
         if (tok->str() == "{")
@@ -1687,7 +1927,11 @@ void CheckMemoryLeakInFunction::check()
         if (indentlevel == 0)
         {
             if (Token::simpleMatch(tok, ") {"))
+            {
                 infunc = true;
+                varnames.clear();
+                allVariables = getAllocatedVariables(tok->next(), varnames);
+            }
 
             else if (tok->str() == "(")
                 beforeParameters = false;
@@ -1719,18 +1963,21 @@ void CheckMemoryLeakInFunction::check()
             if (Token::Match(tok, "[{};] %type% * const| %var% [;=]"))
             {
                 const int varname_tok = (tok->tokAt(3)->str() != "const" ? 3 : 4);
-                checkScope(tok->next(), tok->strAt(varname_tok), classmember, sz);
+                if (allVariables || varnames.find(tok->strAt(varname_tok)) != varnames.end())
+                    checkScope(tok->next(), tok->strAt(varname_tok), classmember, sz);
             }
 
             else if (Token::Match(tok, "[{};] %type% %type% * const| %var% [;=]"))
             {
                 const int varname_tok = (tok->tokAt(4)->str() != "const" ? 4 : 5);
-                checkScope(tok->next(), tok->strAt(varname_tok), classmember, sz);
+                if (allVariables || varnames.find(tok->strAt(varname_tok)) != varnames.end())
+                    checkScope(tok->next(), tok->strAt(varname_tok), classmember, sz);
             }
 
             else if (Token::Match(tok, "[{};] int %var% [;=]"))
             {
-                checkScope(tok->next(), tok->strAt(2), classmember, sz);
+                if (allVariables || varnames.find(tok->strAt(2)) != varnames.end())
+                    checkScope(tok->next(), tok->strAt(2), classmember, sz);
             }
         }
     }
@@ -1829,7 +2076,7 @@ void CheckMemoryLeakInClass::parseClass(const Token *tok1, std::vector<const cha
         if (Token::Match(tok->next(), "%type% * %var% ;"))
         {
             // No false positives for auto deallocated classes..
-            if (_settings->isAutoDealloc(tok->strAt(1)))
+            if (_settings->isAutoDealloc(tok->next()->str()))
                 continue;
 
             if (tok->isName() || Token::Match(tok, "[;}]"))
@@ -2071,24 +2318,11 @@ void CheckMemoryLeakStructMember::check()
                         else if (Token::Match(tok3, "if ( ! %var% . %varid% )", structmemberid))
                         {
                             // Goto the ")"
-                            while (tok3->str() != ")")
-                                tok3 = tok3->next();
+                            tok3 = tok3->next()->link();
 
                             // Skip block..
-                            unsigned int indentlevel = 0;
-                            while (tok3)
-                            {
-                                if (tok3->str() == "{")
-                                    ++indentlevel;
-
-                                else if (tok3->str() == "}")
-                                {
-                                    if (indentlevel <= 1)
-                                        break;
-                                    --indentlevel;
-                                }
-                                tok3 = tok3->next();
-                            }
+                            if (Token::simpleMatch(tok3, ") {"))
+                                tok3 = tok3->next()->link();
                         }
 
                         // Returning from function..
@@ -38,6 +38,8 @@
 #include "check.h"
 
 #include <list>
+#include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -114,6 +116,13 @@ public:
 
     /** What type of allocated memory does the given function return? */
     AllocType functionReturnType(const Token *tok) const;
+
+private:
+    /** Inspect the function, functionReturnType caches the result */
+    AllocType findFunctionReturnType(const Token *tok) const;
+
+    /** The results of functionReturnType */
+    mutable std::map<const Token *, AllocType> _functionReturnTypes;
 };
 
 
@@ -146,8 +155,30 @@ public:
         checkMemoryLeak.check();
     }
 
+    /** Builds and simplifies its own token lists, so it is run alone */
+    bool exclusive() const
+    {
+        return true;
+    }
+
+    void writeSummary(const Tokenizer *tokenizer, const Settings *settings, ErrorLogger *errorLogger, std::ostream &ostr)
+    {
+        CheckMemoryLeakInFunction checkMemoryLeak(tokenizer, settings, errorLogger);
+        checkMemoryLeak.summary(ostr);
+    }
+
+    void readSummary(std::istream &istr, Settings &settings);
+
     void check();
 
+    /**
+     * Write what the global functions allocate and deallocate:
+     * - "alloc funcname type" : the function returns allocated memory
+     * - "dealloc funcname par type" : the function deallocates a parameter
+     * @param ostr the summary is written here
+     */
+    void summary(std::ostream &ostr);
+
 private:
 
     bool matchFunctionsThatReturnArg(const Token *tok, const std::string &varname);
@@ -224,7 +255,11 @@ private:
     void simplifycode(Token *tok, bool &all);
 
     /**
-     * Checking the variable varname
+     * Checking the variable varname. The events of the variable are
+     * collected into a token list by getcode() and reduced by
+     * simplifycode(), so each variable costs a walk over the rest of its
+     * scope. check() only calls this for the variables that
+     * getAllocatedVariables() finds.
      * @param Tok1 start token
      * @param varname name of variable
      * @param classmember is the scope inside a class member function
@@ -232,6 +267,70 @@ private:
      */
     void checkScope(const Token *Tok1, const char varname[], bool classmember, unsigned int sz);
 
+    /**
+     * Get the variables in a function body that checkScope must look at.
+     * All variables are collected in one pass over the body. A variable
+     * that is never assigned the result of a function call or "new",
+     * never given to a function and never deleted can't be allocated
+     * nor deallocated, so checkScope would not find anything for it.
+     * @param tok the "{" of the function body
+     * @param varnames the names of the variables are added here
+     * @return true if all variables must be checked. A deallocation
+     * that doesn't name the variable, e.g. "fcloseall()", can release
+     * any variable.
+     */
+    bool getAllocatedVariables(const Token *tok, std::set<std::string> &varnames);
+
+    /**
+     * Something that getcode does that depends on the state of the
+     * checking: a change of the allocation or deallocation type, which
+     * may give a mismatch error, or a malloc that may have the wrong size.
+     */
+    struct Event
+    {
+        enum Type { ALLOC, DEALLOC, SIZE } type;
+        AllocType alloc;
+        const Token *tok;
+        std::string varname;
+
+        /** The callstack below the function that the event was recorded in */
+        std::list<const Token *> callstack;
+    };
+
+    /**
+     * What a function does with one of its parameters. call_func uses this
+     * so each function is only analysed once for each parameter.
+     */
+    struct FunctionSummary
+    {
+        /** The result of call_func */
+        const char *ret;
+
+        /** Was the "--all" rules used */
+        bool all;
+
+        /** The events are replayed at every call */
+        std::list<Event> events;
+    };
+
+    /**
+     * Handle an event in getcode. The event is also recorded in the
+     * summaries that are being created.
+     * @param event the event, its callstack is ignored
+     * @param callstack the whole callstack
+     * @param alloctype the allocation type of the variable
+     * @param dealloctype the deallocation type of the variable
+     * @param sz size of type, see getcode
+     */
+    void handleEvent(const Event &event, const std::list<const Token *> &callstack, AllocType &alloctype, AllocType &dealloctype, unsigned int sz);
+
+    /** The summaries of the functions that has been analysed. The key is
+     * made up of the callstack, the function name and the parameter */
+    std::map<std::string, FunctionSummary> _functionSummaries;
+
+    /** The summaries that are being created and the sizes of their callstacks */
+    std::list<std::pair<FunctionSummary *, unsigned int> > _summaryRecorders;
+
     void getErrorMessages()
     {
         memleakError(0, "varname");
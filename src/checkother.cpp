@@ -371,78 +371,116 @@ void CheckOther::warningIf()
 
 void CheckOther::invalidFunctionUsage()
 {
-    // strtol and strtoul..
-    for (const Token *tok = _tokenizer->tokens(); tok; tok = tok->next())
-    {
-        if ((tok->str() != "strtol") && (tok->str() != "strtoul"))
-            continue;
+    TokenMatcher matcher;
+    addPattern(matcher, STRTOL);
+    addPattern(matcher, SPRINTF);
+    matcher.run(_tokenizer->tokens());
+}
 
-        // Locate the third parameter of the function call..
-        int parlevel = 0;
-        int param = 1;
-        for (const Token *tok2 = tok->next(); tok2; tok2 = tok2->next())
+void CheckOther::invalidFunctionUsageStrtol(const Token *tok)
+{
+    // Locate the third parameter of the function call..
+    int parlevel = 0;
+    int param = 1;
+    for (const Token *tok2 = tok->next(); tok2; tok2 = tok2->next())
+    {
+        if (tok2->str() == "(")
+            ++parlevel;
+        else if (tok2->str() == ")")
+            --parlevel;
+        else if (parlevel == 1 && tok2->str() == ",")
         {
-            if (tok2->str() == "(")
-                ++parlevel;
-            else if (tok2->str() == ")")
-                --parlevel;
-            else if (parlevel == 1 && tok2->str() == ",")
+            ++param;
+            if (param == 3)
             {
-                ++param;
-                if (param == 3)
+                if (Token::Match(tok2, ", %num% )"))
                 {
-                    if (Token::Match(tok2, ", %num% )"))
+                    int radix = MathLib::toLongNumber(tok2->next()->str());
+                    if (!(radix == 0 || (radix >= 2 && radix <= 36)))
                     {
-                        int radix = MathLib::toLongNumber(tok2->next()->str());
-                        if (!(radix == 0 || (radix >= 2 && radix <= 36)))
-                        {
-                            dangerousUsageStrtolError(tok2);
-                        }
+                        dangerousUsageStrtolError(tok2);
                     }
-                    break;
                 }
+                break;
             }
         }
     }
+}
 
-    // sprintf|snprintf overlapping data
-    for (const Token *tok = _tokenizer->tokens(); tok; tok = tok->next())
-    {
-        // Get variable id of target buffer..
-        unsigned int varid = 0;
+void CheckOther::invalidFunctionUsageSprintf(const Token *tok)
+{
+    // Get variable id of target buffer..
+    unsigned int varid = 0;
 
-        if (Token::Match(tok, "sprintf|snprintf ( %var% ,"))
-            varid = tok->tokAt(2)->varId();
+    if (Token::Match(tok, "sprintf|snprintf ( %var% ,"))
+        varid = tok->tokAt(2)->varId();
 
-        else if (Token::Match(tok, "sprintf|snprintf ( %var% . %var% ,"))
-            varid = tok->tokAt(4)->varId();
+    else if (Token::Match(tok, "sprintf|snprintf ( %var% . %var% ,"))
+        varid = tok->tokAt(4)->varId();
 
-        if (varid == 0)
-            continue;
+    if (varid == 0)
+        return;
 
-        // goto ","
-        const Token *tok2 = tok->tokAt(3);
-        while (tok2 && tok2->str() != ",")
-            tok2 = tok2->next();
+    // goto ","
+    const Token *tok2 = tok->tokAt(3);
+    while (tok2 && tok2->str() != ",")
+        tok2 = tok2->next();
 
-        // is any source buffer overlapping the target buffer?
-        int parlevel = 0;
-        while ((tok2 = tok2->next()) != NULL)
+    // is any source buffer overlapping the target buffer?
+    int parlevel = 0;
+    while ((tok2 = tok2->next()) != NULL)
+    {
+        if (tok2->str() == "(")
+            ++parlevel;
+        else if (tok2->str() == ")")
         {
-            if (tok2->str() == "(")
-                ++parlevel;
-            else if (tok2->str() == ")")
-            {
-                --parlevel;
-                if (parlevel < 0)
-                    break;
-            }
-            else if (parlevel == 0 && Token::Match(tok2, ", %varid% [,)]", varid))
-            {
-                sprintfOverlappingDataError(tok2->next(), tok2->next()->str());
+            --parlevel;
+            if (parlevel < 0)
                 break;
-            }
         }
+        else if (parlevel == 0 && Token::Match(tok2, ", %varid% [,)]", varid))
+        {
+            sprintfOverlappingDataError(tok2->next(), tok2->next()->str());
+            break;
+        }
+    }
+}
+
+void CheckOther::addPattern(TokenMatcher &matcher, Pattern id)
+{
+    // The patterns in the order of the Pattern ids
+    static const char * const patterns[] =
+    {
+        "strtol|strtoul",
+        "sprintf|snprintf ( %var%",
+        "/ 0"
+    };
+
+    matcher.addPattern(patterns[id], this, id);
+}
+
+void CheckOther::addPatterns(TokenMatcher &matcher)
+{
+    addPattern(matcher, STRTOL);
+    addPattern(matcher, SPRINTF);
+    addPattern(matcher, ZERODIV);
+}
+
+void CheckOther::patternMatch(const Token *tok, unsigned int id)
+{
+    switch (id)
+    {
+    case STRTOL:
+        invalidFunctionUsageStrtol(tok);
+        break;
+
+    case SPRINTF:
+        invalidFunctionUsageSprintf(tok);
+        break;
+
+    case ZERODIV:
+        zerodivError(tok);
+        break;
     }
 }
 //---------------------------------------------------------------------------
@@ -963,20 +1001,12 @@ void CheckOther::nullPointer()
 
         // Locate the end of the while loop..
         const Token *tok2 = tok->tokAt(4);
-        int indentlevel = 0;
-        while (tok2)
+        if (tok2 && tok2->str() == "{")
+            tok2 = tok2->link();
+        else
         {
-            if (tok2->str() == "{")
-                ++indentlevel;
-            else if (tok2->str() == "}")
-            {
-                if (indentlevel <= 1)
-                    break;
-                --indentlevel;
-            }
-            else if (indentlevel == 0 && tok2->str() == ";")
-                break;
-            tok2 = tok2->next();
+            while (tok2 && tok2->str() != ";")
+                tok2 = tok2->next();
         }
 
         // Goto next token
@@ -1195,11 +1225,9 @@ void CheckOther::nullPointer()
 
 void CheckOther::checkZeroDivision()
 {
-    for (const Token *tok = _tokenizer->tokens(); tok; tok = tok->next())
-    {
-        if (Token::simpleMatch(tok, "/ 0"))
-            zerodivError(tok);
-    }
+    TokenMatcher matcher;
+    addPattern(matcher, ZERODIV);
+    matcher.run(_tokenizer->tokens());
 }
 
 
@@ -71,11 +71,20 @@ public:
         }
 
         checkOther.strPlusChar();
-        checkOther.invalidFunctionUsage();
         checkOther.nullPointer();
-        checkOther.checkZeroDivision();
+
+        // invalidFunctionUsage and checkZeroDivision are done through the TokenMatcher
     }
 
+    Check *createMatcherCheck(const Tokenizer *tokenizer, const Settings *settings, ErrorLogger *errorLogger)
+    {
+        return new CheckOther(tokenizer, settings, errorLogger);
+    }
+
+    void addPatterns(TokenMatcher &matcher);
+
+    void patternMatch(const Token *tok, unsigned int id);
+
     // Casting
     void warningOldStylePointerCast();
 
@@ -120,6 +129,21 @@ public:
 
     void lookupVar(const Token *tok1, const char varname[]);
 
+    /** ids of the patterns that are registered in addPatterns() */
+    enum Pattern { STRTOL, SPRINTF, ZERODIV };
+
+    /**
+     * Register the pattern of a check. Both addPatterns() and the checks
+     * that are run alone use this, so the patterns are given only here.
+     */
+    void addPattern(TokenMatcher &matcher, Pattern id);
+
+    /** invalid radix given to strtol/strtoul */
+    void invalidFunctionUsageStrtol(const Token *tok);
+
+    /** overlapping data given to sprintf/snprintf */
+    void invalidFunctionUsageSprintf(const Token *tok);
+
     // Redundant condition
     // if (haystack.find(needle) != haystack.end())
     //    haystack.remove(needle);
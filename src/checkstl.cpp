@@ -19,6 +19,7 @@
 #include "checkstl.h"
 #include "tokenize.h"
 #include "token.h"
+#include "tokenmatcher.h"
 
 
 
@@ -41,99 +42,145 @@ void CheckStl::dereferenceErasedError(const Token *tok, const std::string &itern
     reportError(tok, Severity::error, "eraseDereference", "Dereferenced iterator '" + itername + "' has been erased");
 }
 
-void CheckStl::iterators()
+void CheckStl::addPattern(TokenMatcher &matcher, Pattern id)
 {
-    for (const Token *tok = _tokenizer->tokens(); tok; tok = tok->next())
+    // The patterns in the order of the Pattern ids
+    static const char * const patterns[] =
     {
-        if (!Token::Match(tok, "%var% = %var% . begin ( ) ;|+"))
-            continue;
+        "for (",
+        "%var% = %var% . begin ( ) ;|+",
+        "for (",
+        "while ( %var% != %var% . end ( )"
+    };
 
-        const unsigned int iteratorId(tok->varId());
-        const unsigned int containerId(tok->tokAt(2)->varId());
-        if (iteratorId == 0 || containerId == 0)
-            continue;
+    matcher.addPattern(patterns[id], this, id);
+}
 
-        bool validIterator = true;
-        for (const Token *tok2 = tok->tokAt(7); tok2; tok2 = tok2->next())
-        {
-            if (tok2->str() == "}")
-                break;
+void CheckStl::addPatterns(TokenMatcher &matcher)
+{
+    addPattern(matcher, OUT_OF_BOUNDS);
+    addPattern(matcher, ITERATORS);
+    addPattern(matcher, ERASE_FOR);
+    addPattern(matcher, ERASE_WHILE);
+}
 
-            if (Token::Match(tok2, "%varid% != %var% . end ( )", iteratorId) && tok2->tokAt(2)->varId() != containerId)
-            {
-                iteratorsError(tok2, tok->strAt(2), tok2->strAt(2));
-                tok2 = tok2->tokAt(6);
-            }
-            else if (Token::Match(tok2, "%var% . insert|erase ( %varid%", iteratorId))
-            {
-                if (tok2->varId() != containerId)
-                    iteratorsError(tok2, tok->strAt(2), tok2->str());
-                else if (tok2->strAt(2) == std::string("erase"))
-                    validIterator = false;
+void CheckStl::patternMatch(const Token *tok, unsigned int id)
+{
+    switch (id)
+    {
+    case OUT_OF_BOUNDS:
+        stlOutOfBounds(tok);
+        break;
 
-                tok2 = tok2->tokAt(4);
-            }
-            else if (!validIterator && Token::Match(tok2, "* %varid%", iteratorId))
-            {
-                dereferenceErasedError(tok2, tok2->strAt(1));
-                tok2 = tok2->next();
-            }
-            else if (!validIterator && Token::Match(tok2, "%varid% . %var%", iteratorId))
-            {
-                dereferenceErasedError(tok2, tok2->strAt(0));
-                tok2 = tok2->tokAt(2);
-            }
-        }
+    case ITERATORS:
+        iterators(tok);
+        break;
+
+    case ERASE_FOR:
+        eraseFor(tok);
+        break;
+
+    case ERASE_WHILE:
+        eraseCheckLoop(tok->tokAt(2));
+        break;
     }
 }
 
+void CheckStl::iterators()
+{
+    TokenMatcher matcher;
+    addPattern(matcher, ITERATORS);
+    matcher.run(_tokenizer->tokens());
+}
 
-void CheckStl::stlOutOfBounds()
+void CheckStl::iterators(const Token *tok)
 {
-    for (const Token *tok = _tokenizer->tokens(); tok; tok = tok->next())
+    const unsigned int iteratorId(tok->varId());
+    const unsigned int containerId(tok->tokAt(2)->varId());
+    if (iteratorId == 0 || containerId == 0)
+        return;
+
+    bool validIterator = true;
+    for (const Token *tok2 = tok->tokAt(7); tok2; tok2 = tok2->next())
     {
-        if (!Token::simpleMatch(tok, "for ("))
-            continue;
+        if (tok2->str() == "}")
+            break;
 
-        unsigned int indent = 0;
-        for (const Token *tok2 = tok; tok2; tok2 = tok2->next())
+        if (Token::Match(tok2, "%varid% != %var% . end ( )", iteratorId) && tok2->tokAt(2)->varId() != containerId)
+        {
+            iteratorsError(tok2, tok->strAt(2), tok2->strAt(2));
+            tok2 = tok2->tokAt(6);
+        }
+        else if (Token::Match(tok2, "%var% . insert|erase ( %varid%", iteratorId))
         {
+            if (tok2->varId() != containerId)
+                iteratorsError(tok2, tok->strAt(2), tok2->str());
+            else if (tok2->strAt(2) == std::string("erase"))
+                validIterator = false;
 
-            if (tok2->str() == "(")
-                ++indent;
+            tok2 = tok2->tokAt(4);
+        }
+        else if (!validIterator && Token::Match(tok2, "* %varid%", iteratorId))
+        {
+            dereferenceErasedError(tok2, tok2->strAt(1));
+            tok2 = tok2->next();
+        }
+        else if (!validIterator && Token::Match(tok2, "%varid% . %var%", iteratorId))
+        {
+            dereferenceErasedError(tok2, tok2->strAt(0));
+            tok2 = tok2->tokAt(2);
+        }
+    }
+}
 
-            else if (tok2->str() == ")")
-            {
-                if (indent == 0)
-                    break;
-                --indent;
-            }
 
-            if (Token::Match(tok2, "; %var% <= %var% . size ( ) ;"))
+void CheckStl::stlOutOfBounds()
+{
+    TokenMatcher matcher;
+    addPattern(matcher, OUT_OF_BOUNDS);
+    matcher.run(_tokenizer->tokens());
+}
+
+void CheckStl::stlOutOfBounds(const Token *tok)
+{
+    unsigned int indent = 0;
+    for (const Token *tok2 = tok; tok2; tok2 = tok2->next())
+    {
+
+        if (tok2->str() == "(")
+            ++indent;
+
+        else if (tok2->str() == ")")
+        {
+            if (indent == 0)
+                break;
+            --indent;
+        }
+
+        if (Token::Match(tok2, "; %var% <= %var% . size ( ) ;"))
+        {
+            indent = 0;
+            const std::string num(tok2->strAt(1));
+            const std::string varname(tok2->strAt(3));
+            for (const Token *tok3 = tok2->tokAt(8); tok3; tok3 = tok3->next())
             {
-                indent = 0;
-                const std::string num(tok2->strAt(1));
-                const std::string varname(tok2->strAt(3));
-                for (const Token *tok3 = tok2->tokAt(8); tok3; tok3 = tok3->next())
+                if (tok3->str() == "{")
+                    ++indent;
+                else if (tok3->str() == "}")
                 {
-                    if (tok3->str() == "{")
-                        ++indent;
-                    else if (tok3->str() == "}")
-                    {
-                        if (indent == 0)
-                            break;
-                        --indent;
-                    }
-                    else if (tok3->str() == varname)
-                    {
-                        if (Token::simpleMatch(tok3->next(), ". size ( )"))
-                            break;
-                        else if (Token::simpleMatch(tok3->next(), ("[ " + num + " ]").c_str()))
-                            stlOutOfBoundsError(tok3, num, varname);
-                    }
+                    if (indent == 0)
+                        break;
+                    --indent;
+                }
+                else if (tok3->str() == varname)
+                {
+                    if (Token::simpleMatch(tok3->next(), ". size ( )"))
+                        break;
+                    else if (Token::simpleMatch(tok3->next(), ("[ " + num + " ]").c_str()))
+                        stlOutOfBoundsError(tok3, num, varname);
                 }
-                break;
             }
+            break;
         }
     }
 }
@@ -148,25 +195,22 @@ void CheckStl::stlOutOfBoundsError(const Token *tok, const std::string &num, con
 
 void CheckStl::erase()
 {
-    for (const Token *tok = _tokenizer->tokens(); tok; tok = tok->next())
-    {
-        if (Token::simpleMatch(tok, "for ("))
-        {
-            for (const Token *tok2 = tok->tokAt(2); tok2 && tok2->str() != ";"; tok2 = tok2->next())
-            {
-                if (Token::Match(tok2, "%var% = %var% . begin ( ) ; %var% != %var% . end ( ) ") &&
-                    tok2->str() == tok2->tokAt(8)->str() &&
-                    tok2->tokAt(2)->str() == tok2->tokAt(10)->str())
-                {
-                    eraseCheckLoop(tok2);
-                    break;
-                }
-            }
-        }
+    TokenMatcher matcher;
+    addPattern(matcher, ERASE_FOR);
+    addPattern(matcher, ERASE_WHILE);
+    matcher.run(_tokenizer->tokens());
+}
 
-        if (Token::Match(tok, "while ( %var% != %var% . end ( )"))
+void CheckStl::eraseFor(const Token *tok)
+{
+    for (const Token *tok2 = tok->tokAt(2); tok2 && tok2->str() != ";"; tok2 = tok2->next())
+    {
+        if (Token::Match(tok2, "%var% = %var% . begin ( ) ; %var% != %var% . end ( ) ") &&
+            tok2->str() == tok2->tokAt(8)->str() &&
+            tok2->tokAt(2)->str() == tok2->tokAt(10)->str())
         {
-            eraseCheckLoop(tok->tokAt(2));
+            eraseCheckLoop(tok2);
+            break;
         }
     }
 }
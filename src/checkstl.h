@@ -47,13 +47,20 @@ public:
     {
         CheckStl checkStl(tokenizer, settings, errorLogger);
 
-        checkStl.stlOutOfBounds();
-        checkStl.iterators();
-        checkStl.erase();
+        // stlOutOfBounds, iterators and erase are done through the TokenMatcher
         checkStl.pushback();
         checkStl.stlBoundries();
     }
 
+    Check *createMatcherCheck(const Tokenizer *tokenizer, const Settings *settings, ErrorLogger *errorLogger)
+    {
+        return new CheckStl(tokenizer, settings, errorLogger);
+    }
+
+    void addPatterns(TokenMatcher &matcher);
+
+    void patternMatch(const Token *tok, unsigned int id);
+
 
     /**
      * Finds errors like this:
@@ -87,6 +94,24 @@ public:
 
 private:
 
+    /** ids of the patterns that are registered in addPatterns() */
+    enum Pattern { OUT_OF_BOUNDS, ITERATORS, ERASE_FOR, ERASE_WHILE };
+
+    /**
+     * Register the pattern of a check. Both addPatterns() and the checks
+     * that are run alone use this, so the patterns are given only here.
+     */
+    void addPattern(TokenMatcher &matcher, Pattern id);
+
+    /** Check the loop that starts at the given "for" for stlOutOfBounds() */
+    void stlOutOfBounds(const Token *tok);
+
+    /** Check the usage of the iterator that is assigned at the given token for iterators() */
+    void iterators(const Token *tok);
+
+    /** Check the loop that starts at the given "for" for erase() */
+    void eraseFor(const Token *tok);
+
     /**
      * Helper function used by the 'erase' function
      * This function parses a loop
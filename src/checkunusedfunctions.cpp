@@ -21,6 +21,9 @@
 #include "checkunusedfunctions.h"
 #include "tokenize.h"
 #include "token.h"
+#include <istream>
+#include <ostream>
+#include <string>
 //---------------------------------------------------------------------------
 
 
@@ -152,8 +155,55 @@ void CheckUnusedFunctions::parseTokens(const Tokenizer &tokenizer)
 
 
 
-void CheckUnusedFunctions::check()
+void CheckUnusedFunctions::FunctionUsage::merge(const FunctionUsage &other)
 {
+    if (!other.filename.empty())
+    {
+        // No filename set yet..
+        if (filename.empty())
+            filename = other.filename;
+
+        // Multiple files => filename = "+"
+        else if (filename != other.filename)
+        {
+            filename = "+";
+            usedOtherFile |= usedSameFile;
+        }
+    }
+
+    usedSameFile |= other.usedSameFile;
+    usedOtherFile |= other.usedOtherFile;
+}
+
+void CheckUnusedFunctions::writeSummary(std::ostream &ostr) const
+{
+    // One function per line: name usedSameFile usedOtherFile filename
+    for (std::map<std::string, FunctionUsage>::const_iterator it = _functions.begin(); it != _functions.end(); ++it)
+    {
+        const FunctionUsage &func = it->second;
+        ostr << it->first << " "
+             << func.usedSameFile << " "
+             << func.usedOtherFile << " "
+             << func.filename << "\n";
+    }
+}
+
+void CheckUnusedFunctions::readSummary(std::istream &istr)
+{
+    std::string name;
+    FunctionUsage func;
+    while (istr >> name >> func.usedSameFile >> func.usedOtherFile)
+    {
+        // The filename is the rest of the line, it may be empty
+        istr.get();
+        std::getline(istr, func.filename);
+        _functions[name].merge(func);
+    }
+}
+
+unsigned int CheckUnusedFunctions::check()
+{
+    unsigned int count = 0;
     for (std::map<std::string, FunctionUsage>::const_iterator it = _functions.begin(); it != _functions.end(); ++it)
     {
         const FunctionUsage &func = it->second;
@@ -169,6 +219,7 @@ void CheckUnusedFunctions::check()
             else
                 filename = func.filename;
             _errorLogger->unusedFunction(filename, it->first);
+            ++count;
         }
         else if (! func.usedOtherFile)
         {
@@ -180,7 +231,6 @@ void CheckUnusedFunctions::check()
             */
         }
     }
-}
-
-
 
+    return count;
+}
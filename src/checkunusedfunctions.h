@@ -24,6 +24,9 @@
 
 #include "tokenize.h"
 #include "errorlogger.h"
+#include <iosfwd>
+#include <map>
+#include <string>
 
 /// @addtogroup Checks
 /// @{
@@ -46,8 +49,25 @@ public:
     // * What functions are declared
     void parseTokens(const Tokenizer &tokenizer);
 
+    /**
+     * Write the declarations and usage of the functions that are parsed
+     * so far. The summaries of several files can be merged with
+     * readSummary(), and then the merged usage is checked with check().
+     * @param ostr the summary is written here
+     */
+    void writeSummary(std::ostream &ostr) const;
+
+    /**
+     * Merge a summary that is written by writeSummary()
+     * @param istr the summary is read from here
+     */
+    void readSummary(std::istream &istr);
 
-    void check();
+    /**
+     * Report the functions that are declared but not used
+     * @return number of unused functions
+     */
+    unsigned int check();
 
 private:
     ErrorLogger *_errorLogger;
@@ -62,6 +82,9 @@ private:
         std::string filename;
         bool   usedSameFile;
         bool   usedOtherFile;
+
+        /** Merge the usage of the same function in another file */
+        void merge(const FunctionUsage &other);
     };
 
     std::map<std::string, FunctionUsage> _functions;
@@ -0,0 +1,389 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2009 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/
+ */
+
+//---------------------------------------------------------------------------
+#include "compiledatabase.h"
+#include "filelister.h"
+
+#include <cctype>
+#include <cstring>
+#include <sstream>
+//---------------------------------------------------------------------------
+
+namespace
+{
+/** Reads the values of a JSON text one by one */
+class JsonReader
+{
+public:
+    explicit JsonReader(const std::string &text) : _text(text), _pos(0)
+    { }
+
+    /** Skip white space and read the character c if it is next */
+    bool read(char c)
+    {
+        skipSpace();
+        if (_pos >= _text.size() || _text[_pos] != c)
+            return false;
+        ++_pos;
+        return true;
+    }
+
+    /** Read a string value */
+    bool readString(std::string &str)
+    {
+        if (!read('"'))
+            return false;
+
+        str.clear();
+        while (_pos < _text.size() && _text[_pos] != '"')
+        {
+            char c = _text[_pos++];
+            if (c == '\\')
+            {
+                if (_pos >= _text.size())
+                    return false;
+                c = _text[_pos++];
+                switch (c)
+                {
+                case 'b':
+                    c = '\b';
+                    break;
+                case 'f':
+                    c = '\f';
+                    break;
+                case 'n':
+                    c = '\n';
+                    break;
+                case 'r':
+                    c = '\r';
+                    break;
+                case 't':
+                    c = '\t';
+                    break;
+                case 'u':
+                {
+                    if (_pos + 4 > _text.size())
+                        return false;
+                    unsigned int code = 0;
+                    std::istringstream istr(_text.substr(_pos, 4));
+                    if (!(istr >> std::hex >> code))
+                        return false;
+                    _pos += 4;
+
+                    // UTF-8
+                    if (code >= 0x800)
+                    {
+                        str += static_cast<char>(0xE0 | (code >> 12));
+                        str += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                        c = static_cast<char>(0x80 | (code & 0x3F));
+                    }
+                    else if (code >= 0x80)
+                    {
+                        str += static_cast<char>(0xC0 | (code >> 6));
+                        c = static_cast<char>(0x80 | (code & 0x3F));
+                    }
+                    else
+                    {
+                        c = static_cast<char>(code);
+                    }
+                    break;
+                }
+                }
+            }
+            str += c;
+        }
+
+        // The end quote
+        if (_pos >= _text.size())
+            return false;
+        ++_pos;
+        return true;
+    }
+
+    /** Read an array of strings */
+    bool readStringArray(std::list<std::string> &strings)
+    {
+        if (!read('['))
+            return false;
+        for (bool first = true; !read(']'); first = false)
+        {
+            std::string str;
+            if ((!first && !read(',')) || !readString(str))
+                return false;
+            strings.push_back(str);
+        }
+        return true;
+    }
+
+    /** Skip a value of any type */
+    bool skipValue()
+    {
+        skipSpace();
+        if (_pos >= _text.size())
+            return false;
+
+        if (_text[_pos] == '"')
+        {
+            std::string str;
+            return readString(str);
+        }
+
+        if (read('['))
+        {
+            for (bool first = true; !read(']'); first = false)
+            {
+                if ((!first && !read(',')) || !skipValue())
+                    return false;
+            }
+            return true;
+        }
+
+        if (read('{'))
+        {
+            for (bool first = true; !read('}'); first = false)
+            {
+                std::string key;
+                if ((!first && !read(',')) || !readString(key) || !read(':') || !skipValue())
+                    return false;
+            }
+            return true;
+        }
+
+        // number, true, false or null
+        const std::string::size_type start = _pos;
+        while (_pos < _text.size() && (std::isalnum(static_cast<unsigned char>(_text[_pos])) || std::strchr("+-.", _text[_pos])))
+            ++_pos;
+        return (_pos > start);
+    }
+
+    /** The position where the reading stopped */
+    std::string::size_type position() const
+    {
+        return _pos;
+    }
+
+private:
+    void skipSpace()
+    {
+        while (_pos < _text.size() && std::isspace(static_cast<unsigned char>(_text[_pos])))
+            ++_pos;
+    }
+
+    const std::string &_text;
+    std::string::size_type _pos;
+};
+}
+
+/** The path of a file in a directory. Absolute paths are not changed. */
+static std::string getPath(const std::string &directory, const std::string &path)
+{
+    if (path.empty() || path[0] == '/' || path[0] == '\\' || (path.size() > 1 && path[1] == ':'))
+        return FileLister::simplifyPath(path.c_str());
+    return FileLister::simplifyPath((directory + path).c_str());
+}
+
+std::string CompileDatabase::load(std::istream &istr, std::map<std::string, Settings::FileSettings> &fileSettings)
+{
+    std::ostringstream ostr;
+    ostr << istr.rdbuf();
+    const std::string text(ostr.str());
+    JsonReader json(text);
+
+    bool ok = json.read('[');
+    for (bool first = true; ok && !json.read(']'); first = false)
+    {
+        ok = (first || json.read(',')) && json.read('{');
+
+        std::string directory, file, command;
+        std::list<std::string> arguments;
+        bool hasArguments = false;
+        for (bool firstMember = true; ok && !json.read('}'); firstMember = false)
+        {
+            std::string key;
+            ok = (firstMember || json.read(',')) && json.readString(key) && json.read(':');
+            if (!ok)
+                break;
+
+            if (key == "directory")
+                ok = json.readString(directory);
+            else if (key == "file")
+                ok = json.readString(file);
+            else if (key == "command")
+                ok = json.readString(command);
+            else if (key == "arguments")
+                ok = hasArguments = json.readStringArray(arguments);
+            else
+                ok = json.skipValue();
+        }
+        if (!ok)
+            break;
+
+        if (file.empty())
+            return "there is no \"file\" in a command of the compilation database";
+
+        if (!directory.empty() && directory[directory.length()-1] != '/' && directory[directory.length()-1] != '\\')
+            directory += '/';
+
+        // The first command of a file is used
+        const std::string filename(getPath(directory, file));
+        if (fileSettings.find(filename) == fileSettings.end())
+            fileSettings[filename] = getFileSettings(hasArguments ? arguments : splitCommand(command), directory);
+    }
+
+    if (!ok)
+    {
+        std::ostringstream errmsg;
+        errmsg << "syntax error in the compilation database at character " << json.position();
+        return errmsg.str();
+    }
+
+    return "";
+}
+
+std::list<std::string> CompileDatabase::splitCommand(const std::string &command)
+{
+    std::list<std::string> arguments;
+    std::string argument;
+    bool inArgument = false;
+    char quote = 0;
+    for (std::string::size_type i = 0; i < command.length(); ++i)
+    {
+        const char c = command[i];
+
+        // Everything is literal within single quotes
+        if (quote == '\'')
+        {
+            if (c == '\'')
+                quote = 0;
+            else
+                argument += c;
+        }
+
+        // Within double quotes, backslash escapes only some characters
+        else if (c == '\\' && i + 1 < command.length() && (quote == 0 || std::strchr("\"\\$`", command[i+1])))
+        {
+            argument += command[++i];
+            inArgument = true;
+        }
+
+        else if (quote == '"')
+        {
+            if (c == '"')
+                quote = 0;
+            else
+                argument += c;
+        }
+
+        else if (c == '"' || c == '\'')
+        {
+            quote = c;
+            inArgument = true;
+        }
+
+        else if (std::isspace(static_cast<unsigned char>(c)))
+        {
+            if (inArgument)
+                arguments.push_back(argument);
+            argument.clear();
+            inArgument = false;
+        }
+
+        else
+        {
+            argument += c;
+            inArgument = true;
+        }
+    }
+
+    if (inArgument)
+        arguments.push_back(argument);
+
+    return arguments;
+}
+
+Settings::FileSettings CompileDatabase::getFileSettings(const std::list<std::string> &arguments, const std::string &directory)
+{
+    Settings::FileSettings fileSettings;
+
+    // The defines, e.g. "DEBUG=1"
+    std::list<std::string> defines;
+
+    for (std::list<std::string>::const_iterator it = arguments.begin(); it != arguments.end(); ++it)
+    {
+        std::string flag, value;
+        if (it->compare(0, 7, "-iquote") == 0)
+        {
+            flag = "-iquote";
+            value = it->substr(7);
+        }
+        else if (it->compare(0, 2, "-D") == 0 || it->compare(0, 2, "-U") == 0 || it->compare(0, 2, "-I") == 0)
+        {
+            flag = it->substr(0, 2);
+            value = it->substr(2);
+        }
+        else
+        {
+            continue;
+        }
+
+        // "-D NAME"
+        if (value.empty())
+        {
+            std::list<std::string>::const_iterator next = it;
+            if (++next == arguments.end())
+                break;
+            it = next;
+            value = *it;
+        }
+
+        if (flag == "-D" || flag == "-U")
+        {
+            // The last -D or -U of a name is used
+            const std::string name(value.substr(0, value.find("=")));
+            for (std::list<std::string>::iterator define = defines.begin(); define != defines.end();)
+            {
+                if (define->substr(0, define->find("=")) == name)
+                    define = defines.erase(define);
+                else
+                    ++define;
+            }
+
+            // "-DNAME" is the same as "-DNAME=1"
+            if (flag == "-D")
+                defines.push_back(value.find("=") == std::string::npos ? value + "=1" : value);
+        }
+
+        else
+        {
+            std::string path(getPath(directory, value));
+            if (path[path.length()-1] != '/' && path[path.length()-1] != '\\')
+                path += '/';
+            fileSettings._includePaths.push_back(path);
+        }
+    }
+
+    for (std::list<std::string>::const_iterator it = defines.begin(); it != defines.end(); ++it)
+    {
+        if (it != defines.begin())
+            fileSettings._cfg += ";";
+        fileSettings._cfg += *it;
+    }
+
+    return fileSettings;
+}
@@ -0,0 +1,82 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2009 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/
+ */
+
+//---------------------------------------------------------------------------
+#ifndef compiledatabaseH
+#define compiledatabaseH
+//---------------------------------------------------------------------------
+
+#include <istream>
+#include <list>
+#include <map>
+#include <string>
+#include "settings.h"
+
+/// @addtogroup Core
+/// @{
+
+/**
+ * @brief Read the files and their compiler flags from a compilation
+ * database, i.e. a compile_commands.json file.
+ *
+ * The database is a JSON array with an object for each compiled file:
+ * \code
+ * [ { "directory": "/project/build",
+ *     "command": "g++ -DDEBUG -I../include -c ../src/main.cpp",
+ *     "file": "../src/main.cpp" } ]
+ * \endcode
+ * Instead of "command" the object can have "arguments", which is an array
+ * of the command line arguments. The -D and -U flags give the configuration
+ * that is checked, and the -I and -iquote flags give the include paths.
+ * Relative paths are relative to "directory".
+ */
+class CompileDatabase
+{
+public:
+    /**
+     * Read a compilation database. If a file is compiled several times,
+     * the first command is used.
+     * @param istr the compile_commands.json file
+     * @param fileSettings the files and their preprocessor settings are
+     * added here, see Settings::_fileSettings
+     * @return empty string if the database was read, otherwise an error
+     * message
+     */
+    static std::string load(std::istream &istr, std::map<std::string, Settings::FileSettings> &fileSettings);
+
+    /**
+     * Split a command line into arguments like a POSIX shell does it.
+     * Quotes and backslashes are handled, nothing is expanded.
+     * @param command e.g. "g++ -DNAME=\"a b\" -c main.cpp"
+     * @return the arguments, e.g. "g++", "-DNAME=a b", "-c" and "main.cpp"
+     */
+    static std::list<std::string> splitCommand(const std::string &command);
+
+    /**
+     * Get the preprocessor settings from compiler arguments
+     * @param arguments the compiler and its arguments
+     * @param directory the working directory of the compiler, ending with '/'
+     * @return the defines and the include paths
+     */
+    static Settings::FileSettings getFileSettings(const std::list<std::string> &arguments, const std::string &directory);
+};
+
+/// @}
+
+//---------------------------------------------------------------------------
+#endif
@@ -21,8 +21,13 @@
 #include "tokenize.h"   // <- Tokenizer
 
 #include "filelister.h"
+#include "compiledatabase.h"
+#include "filecache.h"
+#include "filereader.h"
 
 #include "check.h"
+#include "tokenmatcher.h"
+#include "errorqueue.h"
 
 #include <algorithm>
 #include <iostream>
@@ -30,17 +35,31 @@
 #include <cstring>
 #include <fstream>
 #include <map>
+#include <set>
 #include <stdexcept>
 
 #ifdef __GNUC__
 #include <ctime> // clock_t
 #endif
 
+#if defined(__GNUC__) && !defined(__MINGW32__)
+#include <pthread.h>
+#include <sys/time.h>
+#endif
+
 //---------------------------------------------------------------------------
 
 CppCheck::CppCheck(ErrorLogger &errorLogger)
 {
     _errorLogger = &errorLogger;
+    _reportUnusedFunctions = true;
+    _summariesLoaded = false;
+    _fileCache = 0;
+    _fileReader = 0;
+    _fileResults = 0;
+    _cfgIndex = 0;
+    _cfgCount = 0;
+    _tokenCount = 0;
 }
 
 CppCheck::~CppCheck()
@@ -51,11 +70,27 @@ CppCheck::~CppCheck()
 void CppCheck::settings(const Settings &settings)
 {
     _settings = settings;
+
+    // The summaries are read into the settings
+    _summariesLoaded = false;
 }
 
 void CppCheck::addFile(const std::string &path)
 {
-    FileLister::recursiveAddFiles(_filenames, path.c_str(), true);
+    _paths.push_back(path);
+}
+
+void CppCheck::addPaths()
+{
+    for (std::vector<std::string>::const_iterator it = _paths.begin(); it != _paths.end(); ++it)
+    {
+        // The files that are read through the reader are not in the file system
+        if (!_fileReader)
+            FileLister::recursiveAddFiles(_filenames, *it, true, _settings._exclude);
+        else if (!FileLister::excluded(*it, _settings._exclude) && FileLister::acceptFile(*it))
+            _filenames.push_back(*it);
+    }
+    _paths.clear();
 }
 
 void CppCheck::addFile(const std::string &path, const std::string &content)
@@ -66,6 +101,7 @@ void CppCheck::addFile(const std::string &path, const std::string &content)
 
 void CppCheck::clearFiles()
 {
+    _paths.clear();
     _filenames.clear();
     _fileContents.clear();
 }
@@ -120,6 +156,10 @@ std::string CppCheck::parseFromArgs(int argc, const char* const argv[])
             _settings._showtime = true;
 #endif
 
+        // Show the phase of the checking of each file
+        else if (strcmp(argv[i], "--progress") == 0)
+            _settings._progress = true;
+
         // Print help
         else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0)
         {
@@ -172,6 +212,46 @@ std::string CppCheck::parseFromArgs(int argc, const char* const argv[])
             _settings._includePaths.push_back(path);
         }
 
+        // Excluded paths and patterns
+        else if (strncmp(argv[i], "-i", 2) == 0 || strncmp(argv[i], "--exclude=", 10) == 0)
+        {
+            const std::string option(argv[i][1] == '-' ? "--exclude" : "-i");
+            std::string path;
+
+            // "-i path/"
+            if (strcmp(argv[i], "-i") == 0)
+            {
+                ++i;
+                if (i >= argc)
+                    return "cppcheck: argument to '-i' is missing\n";
+
+                path = argv[i];
+            }
+
+            // "--exclude=path/"
+            else if (option == "--exclude")
+            {
+                path = std::string(argv[i]).substr(10);
+            }
+
+            // "-ipath/"
+            else
+            {
+                path = std::string(argv[i]).substr(2);
+            }
+
+            // Remove "./" from the start and "/" from the end
+            while (path.compare(0, 2, "./") == 0 || path.compare(0, 2, ".\\") == 0)
+                path.erase(0, 2);
+            while (path.length() > 1 && (path[path.length()-1] == '/' || path[path.length()-1] == '\\'))
+                path.erase(path.length() - 1);
+
+            if (path.empty())
+                return "cppcheck: argument to '" + option + "' is missing\n";
+
+            _settings._exclude.push_back(path);
+        }
+
 // Include paths
         else if (strcmp(argv[i], "-j") == 0 ||
                  strncmp(argv[i], "-j", 2) == 0)
@@ -205,6 +285,57 @@ std::string CppCheck::parseFromArgs(int argc, const char* const argv[])
             }
         }
 
+        // --check-threads=4
+        else if (strncmp(argv[i], "--check-threads=", 16) == 0)
+        {
+            std::istringstream iss(std::string(argv[i]).substr(16));
+            if (!(iss >> _settings._checkThreads) || _settings._checkThreads == 0)
+            {
+                _settings._checkThreads = 1;
+                return "cppcheck: argument to '--check-threads' must be a positive integer\n";
+            }
+
+            if (_settings._checkThreads > 1000)
+            {
+                return "cppcheck: argument for '--check-threads' is allowed to be 1000 at max\n";
+            }
+        }
+
+        // --summaries=dir
+        else if (strncmp(argv[i], "--summaries=", 12) == 0)
+        {
+            std::string path = std::string(argv[i]).substr(12);
+            if (path.empty())
+                return "cppcheck: argument to '--summaries' is missing\n";
+
+            // If path doesn't end with / or \, add it
+            if (path[path.length()-1] != '/' && path[path.length()-1] != '\\')
+                path += '/';
+
+            _settings._summaryDir = path;
+        }
+
+        // --daemon=socket
+        else if (strncmp(argv[i], "--daemon=", 9) == 0)
+        {
+            _settings._daemon = std::string(argv[i]).substr(9);
+            if (_settings._daemon.empty())
+                return "cppcheck: argument to '--daemon' is missing\n";
+        }
+
+        // --compile-commands=compile_commands.json
+        else if (strncmp(argv[i], "--compile-commands=", 19) == 0)
+        {
+            const std::string filename(std::string(argv[i]).substr(19));
+            std::ifstream f(filename.c_str());
+            if (!f.is_open())
+                return "cppcheck: couldn't open the file \"" + filename + "\"\n";
+
+            const std::string errmsg(CompileDatabase::load(f, _settings._fileSettings));
+            if (!errmsg.empty())
+                return "cppcheck: " + filename + ": " + errmsg + "\n";
+        }
+
         // auto deallocated classes..
         else if (strcmp(argv[i], "--auto-dealloc") == 0)
         {
@@ -260,17 +391,21 @@ std::string CppCheck::parseFromArgs(int argc, const char* const argv[])
             pathnames.push_back(argv[i]);
     }
 
-    if (_settings._unusedFunctions && _settings._jobs > 1)
-    {
-        return "cppcheck: error: --unused-functions can't be used with -j option.\n";
-    }
-
     if (pathnames.size() > 0)
     {
         // Execute recursiveAddFiles() to each given file parameter
         std::vector<std::string>::const_iterator iter;
         for (iter = pathnames.begin(); iter != pathnames.end(); iter++)
-            FileLister::recursiveAddFiles(_filenames, iter->c_str(), true);
+            FileLister::recursiveAddFiles(_filenames, iter->c_str(), true, _settings._exclude);
+    }
+
+    // Add the files in the compilation database that are not added yet
+    std::set<std::string> added(_filenames.begin(), _filenames.end());
+    for (std::map<std::string, Settings::FileSettings>::const_iterator it = _settings._fileSettings.begin(); it != _settings._fileSettings.end(); ++it)
+    {
+        if (!FileLister::excluded(it->first, _settings._exclude) &&
+            added.insert(it->first).second)
+            _filenames.push_back(it->first);
     }
 
     if (argc <= 1 || showHelp)
@@ -279,8 +414,11 @@ std::string CppCheck::parseFromArgs(int argc, const char* const argv[])
         oss <<   "Cppcheck - A tool for static C/C++ code analysis\n"
         "\n"
         "Syntax:\n"
-        "    cppcheck [--all] [--auto-dealloc file.lst] [--error-exitcode=[n]] [--force]\n"
-        "             [--help] [-Idir] [-j [jobs]] [--quiet] [--style] [--unused-functions]\n"
+        "    cppcheck [--all] [--auto-dealloc file.lst] [--check-threads=[n]]\n"
+        "             [--compile-commands=file] [--daemon=socket]\n"
+        "             [--error-exitcode=[n]] [--force] [--help] [-Idir] [-i path]\n"
+        "             [-j [jobs]] [--quiet] [--style] [--summaries=dir]\n"
+        "             [--unused-functions]\n"
         "             [--verbose] [--version] [--xml] [file or path1] [file or path] ...\n"
         "\n"
         "If path is given instead of filename, *.cpp, *.cxx, *.cc, *.c++ and *.c files\n"
@@ -294,6 +432,23 @@ std::string CppCheck::parseFromArgs(int argc, const char* const argv[])
         "                         classname / line - in a .lst file.\n"
         "                         This option can be used several times, allowing you to\n"
         "                         specify several .lst files.\n"
+        "    --check-threads=[n]  Run the checks of a file in [n] threads. This is\n"
+        "                         useful when there are big files to check.\n"
+        "    --compile-commands=file\n"
+        "                         Check the files in a compilation database, e.g.\n"
+        "                         compile_commands.json. Only the configuration that\n"
+        "                         is given by the -D and -U flags of a file is checked,\n"
+        "                         and the include paths of its -I flags are used.\n"
+        "    --daemon=socket      Don't exit after the checking. Listen to the local\n"
+        "                         socket and check files on request. Write the line\n"
+        "                         \"check path\" to the socket to check the file or the\n"
+        "                         directory, and \"shutdown\" to stop the daemon. The\n"
+        "                         errors are written back, followed by \"done [n]\".\n"
+        "                         Included files that have not changed are not read\n"
+        "                         again, and files that have not changed are not\n"
+        "                         checked again. With --summaries, the summaries of\n"
+        "                         the files that are given are made when the daemon\n"
+        "                         starts.\n"
         "    --error-exitcode=[n] If errors are found, integer [n] is returned instead\n"
         "                         of default 0. EXIT_FAILURE is returned\n"
         "                         if arguments are not valid or if no input files are\n"
@@ -305,9 +460,24 @@ std::string CppCheck::parseFromArgs(int argc, const char* const argv[])
         "    -I [dir]             Give include path. Give several -I parameters to give\n"
         "                         several paths. First given path is checked first. If\n"
         "                         paths are relative to source files, this is not needed\n"
+        "    -i [path]            Don't check the files in path. The path can be a file\n"
+        "                         or a directory, or a pattern with the wildcards * and\n"
+        "                         ? that is matched with the paths and the names of the\n"
+        "                         files and directories. The excluded directories are\n"
+        "                         not searched. Give several -i parameters to exclude\n"
+        "                         several paths.\n"
+        "    --exclude=[path]     Same as -i [path]\n"
         "    -j [jobs]            Start [jobs] threads to do the checking simultaneously.\n"
+        "    --progress           Print the configuration and the phase of the checking\n"
+        "                         when it changes, and the amount of code that the\n"
+        "                         phase handles in bytes or tokens.\n"
         "    -q, --quiet          Only print error messages\n"
         "    -s, --style          Check coding style\n"
+        "    --summaries=dir      Save summaries of the functions of all files in dir\n"
+        "                         before the checking. Then functions in other files\n"
+        "                         that allocate and deallocate memory are known when a\n"
+        "                         file is checked. The summaries are updated only for\n"
+        "                         files that have changed since the last run.\n"
         "    --unused-functions   Check if there are unused functions\n"
         "    -v, --verbose        More detailed error reports\n"
         "    --version            Print out version number\n"
@@ -322,10 +492,12 @@ std::string CppCheck::parseFromArgs(int argc, const char* const argv[])
         "  # Check only files one.cpp and two.cpp and give all information there is:\n"
         "    cppcheck -v -a -s one.cpp two.cpp\n"
         "  # Check f.cpp and search include files from inc1/ and inc2/:\n"
-        "    cppcheck -I inc1/ -I inc2/ f.cpp\n";
+        "    cppcheck -I inc1/ -I inc2/ f.cpp\n"
+        "  # Recursively check src/ but not the third party and generated code:\n"
+        "    cppcheck -i src/third_party --exclude=*_generated.cpp src/\n";
         return oss.str();
     }
-    else if (_filenames.empty())
+    else if (_filenames.empty() && _settings._daemon.empty())
     {
         return "cppcheck: No C or C++ source files found.\n";
     }
@@ -337,10 +509,14 @@ std::string CppCheck::parseFromArgs(int argc, const char* const argv[])
 unsigned int CppCheck::check()
 {
     _checkUnusedFunctions.setErrorLogger(this);
+    addPaths();
     std::sort(_filenames.begin(), _filenames.end());
-    for (unsigned int c = 0; c < _filenames.size(); c++)
+
+    if (!_settings._summaryDir.empty() && !_summariesLoaded)
+        createSummaries();
+
+    for (unsigned int c = 0; c < _filenames.size() && !_settings.terminated(); c++)
     {
-        _errout.str("");
         std::string fname = _filenames[c];
 
         if (_settings._errorsOnly == false)
@@ -348,23 +524,70 @@ unsigned int CppCheck::check()
 
         try
         {
-            Preprocessor preprocessor(&_settings, this);
+            Preprocessor preprocessor(&_settings, this, _fileCache, _fileReader);
             std::list<std::string> configurations;
             std::string filedata = "";
 
-            if (_fileContents.size() > 0 && _fileContents.find(_filenames[c]) != _fileContents.end())
+            // The file is in the compilation database => check only the
+            // configuration that it is compiled with
+            std::list<std::string> includePaths(_settings._includePaths);
+            std::map<std::string, Settings::FileSettings>::const_iterator fileSettings = _settings._fileSettings.find(fname);
+            if (fileSettings != _settings._fileSettings.end())
             {
-                // File content was given as a string
-                std::istringstream iss(_fileContents[ _filenames[c] ]);
-                preprocessor.preprocess(iss, filedata, configurations, fname, _settings._includePaths);
+                includePaths.insert(includePaths.begin(), fileSettings->second._includePaths.begin(), fileSettings->second._includePaths.end());
+                configurations.push_back(fileSettings->second._cfg);
+            }
+
+            std::map<std::string, std::string>::const_iterator fileContent = _fileContents.find(fname);
+            std::string code;
+            if (fileContent != _fileContents.end() || _fileReader)
+            {
+                // File content was given as a string or it is read through
+                // the file reader. A file that can't be read is empty, as
+                // it is when it is read from the file system.
+                if (fileContent == _fileContents.end())
+                    _fileReader->read(fname, code);
+                const std::string &content = (fileContent != _fileContents.end()) ? fileContent->second : code;
+                if (configurations.empty())
+                    preprocessor.preprocess(content, filedata, configurations, fname, includePaths);
+                else
+                    preprocessor.preprocess(content, filedata, fname, includePaths);
             }
             else
             {
                 // Only file name was given, read the content from file
                 std::ifstream fin(fname.c_str());
-                preprocessor.preprocess(fin, filedata, configurations, fname, _settings._includePaths);
+                if (configurations.empty())
+                    preprocessor.preprocess(fin, filedata, configurations, fname, includePaths);
+                else
+                    preprocessor.preprocess(fin, filedata, fname, includePaths);
             }
 
+            // The results are cached => if the code has not changed, report
+            // the same errors again instead of checking the file. The usage
+            // of the functions is not cached. The summaries of the other
+            // files are a part of the code that is checked.
+            std::list<ErrorLogger::ErrorMessage> fileResults;
+            const std::string cacheCode(_settings._summaryHeaders + filedata);
+            if (_fileCache && !_settings._unusedFunctions)
+            {
+                const std::list<ErrorLogger::ErrorMessage> *results = _fileCache->results(fname, cacheCode);
+                if (results)
+                {
+                    for (std::list<ErrorLogger::ErrorMessage>::const_iterator it = results->begin(); it != results->end(); ++it)
+                        reportErr(*it);
+                    _errorLogger->reportStatus(c + 1, _filenames.size());
+                    continue;
+                }
+                _fileResults = &fileResults;
+            }
+
+            _progressFile = fname;
+            _cfgIndex = 0;
+            _cfgCount = static_cast<unsigned int>(configurations.size());
+            if (!_settings._force && _cfgCount > 12)
+                _cfgCount = 12;
+
             int checkCount = 0;
             for (std::list<std::string>::const_iterator it = configurations.begin(); it != configurations.end(); ++it)
             {
@@ -378,18 +601,24 @@ unsigned int CppCheck::check()
                     break;
                 }
 
+                if (_settings.terminated())
+                    break;
+
                 cfg = *it;
+                ++_cfgIndex;
+                progress("preprocess", static_cast<unsigned int>(filedata.size()));
 #ifdef __GNUC__
                 clock_t c1 = clock();
-                const std::string codeWithoutCfg = Preprocessor::getcode(filedata, *it, fname, _errorLogger);
+                const std::string codeWithoutCfg = Preprocessor::getcode(filedata, *it, fname, _errorLogger, &_settings);
                 if (_settings._showtime)
                 {
                     clock_t c2 = clock();
                     std::cout << "Preprocessor::getcode: " << ((c2 - c1) / 1000) << std::endl;
                 }
 #else
-                std::string codeWithoutCfg = Preprocessor::getcode(filedata, *it, fname, _errorLogger);
+                std::string codeWithoutCfg = Preprocessor::getcode(filedata, *it, fname, _errorLogger, &_settings);
 #endif
+                progress("tokenize", static_cast<unsigned int>(codeWithoutCfg.size()));
 
                 // If only errors are printed, print filename after the check
                 if (_settings._errorsOnly == false && it != configurations.begin())
@@ -398,9 +627,16 @@ unsigned int CppCheck::check()
                 checkFile(codeWithoutCfg, _filenames[c].c_str());
                 ++checkCount;
             }
+
+            // The results of a terminated check are not complete
+            if (_fileResults && !_settings.terminated())
+                _fileCache->results(fname, cacheCode, fileResults);
+            _fileResults = 0;
         }
         catch (std::runtime_error &e)
         {
+            _fileResults = 0;
+
             // Exception was thrown when checking this file..
             _errorLogger->reportOut("Bailing out from checking " + fname + ": " + e.what());
         }
@@ -410,9 +646,8 @@ unsigned int CppCheck::check()
 
     // This generates false positives - especially for libraries
     _settings._verbose = false;
-    if (_settings._unusedFunctions)
+    if (_settings._unusedFunctions && _reportUnusedFunctions && !_settings.terminated())
     {
-        _errout.str("");
         if (_settings._errorsOnly == false)
             _errorLogger->reportOut("Checking usage of global functions..");
 
@@ -427,10 +662,168 @@ unsigned int CppCheck::check()
 }
 
 
+//---------------------------------------------------------------------------
+// Function summaries
+//---------------------------------------------------------------------------
+
+namespace
+{
+/** The errors found while the summaries are written are not reported */
+class SilentErrorLogger : public ErrorLogger
+{
+public:
+    void reportOut(const std::string &)
+    { }
+
+    void reportErr(const ErrorLogger::ErrorMessage &)
+    { }
+
+    void reportStatus(unsigned int, unsigned int)
+    { }
+};
+
+/** The first line of a summary file, it tells what code the summary is for */
+std::string summaryHeader(const std::string &code)
+{
+    return "cppcheck-summary " + FileCache::digest(code);
+}
+}
+
+std::string CppCheck::summaryFileName(const std::string &filename) const
+{
+    // Escape the characters that can't be in a file name, and '_' so
+    // that different paths can't get the same name
+    std::string name;
+    for (std::string::size_type pos = 0; pos < filename.size(); ++pos)
+    {
+        if (filename[pos] == '_')
+            name += "_5f";
+        else if (filename[pos] == '/')
+            name += "_2f";
+        else if (filename[pos] == '\\')
+            name += "_5c";
+        else if (filename[pos] == ':')
+            name += "_3a";
+        else
+            name += filename[pos];
+    }
+    return _settings._summaryDir + name + ".summary";
+}
+
+void CppCheck::createSummary(const std::string &filename)
+{
+    SilentErrorLogger silentErrorLogger;
+
+    try
+    {
+        Preprocessor preprocessor(&_settings, &silentErrorLogger, 0, _fileReader);
+        std::list<std::string> configurations;
+        std::string filedata;
+
+        std::map<std::string, std::string>::const_iterator fileContent = _fileContents.find(filename);
+        std::string code;
+        if (fileContent != _fileContents.end() || _fileReader)
+        {
+            if (fileContent == _fileContents.end())
+                _fileReader->read(filename, code);
+            const std::string &content = (fileContent != _fileContents.end()) ? fileContent->second : code;
+            preprocessor.preprocess(content, filedata, configurations, filename, _settings._includePaths);
+        }
+        else
+        {
+            std::ifstream fin(filename.c_str());
+            preprocessor.preprocess(fin, filedata, configurations, filename, _settings._includePaths);
+        }
+
+        // Keep the old summary if the code has not changed
+        const std::string header(summaryHeader(filedata));
+        const std::string summaryFile(summaryFileName(filename));
+        {
+            std::ifstream fin(summaryFile.c_str());
+            std::string line;
+            if (std::getline(fin, line) && line == header)
+                return;
+        }
+
+        std::ostringstream summary;
+        int checkCount = 0;
+        for (std::list<std::string>::const_iterator it = configurations.begin(); it != configurations.end(); ++it, ++checkCount)
+        {
+            if (!_settings._force && checkCount > 11)
+                break;
+
+            const std::string code = Preprocessor::getcode(filedata, *it, filename, &silentErrorLogger);
+
+            Tokenizer tokenizer(&_settings, &silentErrorLogger);
+            std::istringstream istr(code);
+            if (!tokenizer.tokenize(istr, filename.c_str()))
+                continue;
+            tokenizer.setVarId();
+            tokenizer.fillFunctionList();
+            tokenizer.simplifyTokenList();
+
+            // Don't write a partial summary
+            if (_settings.terminated())
+                return;
+
+            for (std::list<Check *>::iterator check = Check::instances().begin(); check != Check::instances().end(); ++check)
+                (*check)->writeSummary(&tokenizer, &_settings, &silentErrorLogger, summary);
+        }
+
+        std::ofstream fout(summaryFile.c_str());
+        fout << header << "\n" << summary.str();
+    }
+    catch (std::runtime_error &)
+    {
+        // The file is checked later and then the error is reported
+    }
+}
+
+void CppCheck::createSummaries()
+{
+    addPaths();
+    for (unsigned int c = 0; c < _filenames.size() && !_settings.terminated(); c++)
+        createSummary(_filenames[c]);
+    loadSummaries();
+}
+
+void CppCheck::loadSummaries()
+{
+    addPaths();
+    _summariesLoaded = true;
+    for (unsigned int c = 0; c < _filenames.size(); c++)
+    {
+        std::ifstream fin(summaryFileName(_filenames[c]).c_str());
+        std::string header;
+        if (std::getline(fin, header))
+            _settings._summaryHeaders += header + "\n";
+        std::ostringstream summary;
+        summary << fin.rdbuf();
+
+        for (std::list<Check *>::iterator it = Check::instances().begin(); it != Check::instances().end(); ++it)
+        {
+            std::istringstream istr(summary.str());
+            (*it)->readSummary(istr, _settings);
+        }
+    }
+}
+
 //---------------------------------------------------------------------------
 // CppCheck - A function that checks a specified file
 //---------------------------------------------------------------------------
 
+namespace
+{
+/** The number of tokens in a token list */
+unsigned int countTokens(const Token *tok)
+{
+    unsigned int count = 0;
+    for (; tok; tok = tok->next())
+        ++count;
+    return count;
+}
+}
+
 void CppCheck::checkFile(const std::string &code, const char FileName[])
 {
     Tokenizer _tokenizer(&_settings, this);
@@ -445,16 +838,23 @@ void CppCheck::checkFile(const std::string &code, const char FileName[])
         }
     }
 
+    if (_settings.terminated())
+        return;
+
+    _tokenCount = countTokens(_tokenizer.tokens());
+
     // Set variable id
     _tokenizer.setVarId();
 
     _tokenizer.fillFunctionList();
 
     // call all "runChecks" in all registered Check classes
-    for (std::list<Check *>::iterator it = Check::instances().begin(); it != Check::instances().end(); ++it)
-    {
-        (*it)->runChecks(&_tokenizer, &_settings, this);
-    }
+    runChecks(_tokenizer, false);
+
+    if (_settings.terminated())
+        return;
+
+    progress("simplify", _tokenCount);
 
 #ifdef __GNUC__
     {
@@ -468,20 +868,211 @@ void CppCheck::checkFile(const std::string &code, const char FileName[])
     _tokenizer.simplifyTokenList();
 #endif
 
+    if (_settings.terminated())
+        return;
+
+    _tokenCount = countTokens(_tokenizer.tokens());
+
     if (_settings._unusedFunctions)
         _checkUnusedFunctions.parseTokens(_tokenizer);
 
+    // Find the patterns that the checks have registered in one walk
+    // through the simplified token list
+    {
+        TokenMatcher matcher;
+        std::list<Check *> matcherChecks;
+        for (std::list<Check *>::iterator it = Check::instances().begin(); it != Check::instances().end(); ++it)
+        {
+            Check *check = (*it)->createMatcherCheck(&_tokenizer, &_settings, this);
+            if (check)
+            {
+                check->addPatterns(matcher);
+                matcherChecks.push_back(check);
+            }
+        }
+
+        progress("match", _tokenCount);
+#ifdef __GNUC__
+        clock_t c1 = clock();
+        matcher.run(_tokenizer.tokens());
+        clock_t c2 = clock();
+        if (_settings._showtime)
+            std::cout << "TokenMatcher::run: " << ((c2 - c1) / 1000) << std::endl;
+#else
+        matcher.run(_tokenizer.tokens());
+#endif
+
+        while (!matcherChecks.empty())
+        {
+            delete matcherChecks.back();
+            matcherChecks.pop_back();
+        }
+    }
+
+    if (_settings.terminated())
+        return;
+
     // call all "runSimplifiedChecks" in all registered Check classes
-    for (std::list<Check *>::iterator it = Check::instances().begin(); it != Check::instances().end(); ++it)
+    runChecks(_tokenizer, true);
+}
+
+//---------------------------------------------------------------------------
+// Running the checks of a file in several threads
+//---------------------------------------------------------------------------
+
+#if defined(__GNUC__) && !defined(__MINGW32__)
+namespace
+{
+/**
+ * The checks that the worker threads take one at a time. The messages of
+ * each check are written into its own buffer and handed to the ErrorQueue,
+ * so the threads don't share anything but the job counter.
+ */
+struct JobQueue
+{
+    /** the checks to run and their positions in the output */
+    std::vector<std::pair<Check *, unsigned int> > jobs;
+    /** wall time of each job in ms, when --showtime is used */
+    std::vector<long> times;
+    unsigned int next;
+    bool simplified;
+    const Tokenizer *tokenizer;
+    const Settings *settings;
+    ErrorQueue *errors;
+};
+
+/** Wall time in ms. The checks run at the same time, so clock() can't be used */
+long milliseconds()
+{
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+    return tv.tv_sec * 1000L + tv.tv_usec / 1000L;
+}
+
+/** Run one job. @return false if there are no jobs left */
+bool runJob(JobQueue *queue)
+{
+    const unsigned int job = __sync_fetch_and_add(&queue->next, 1);
+    if (job >= queue->jobs.size() || queue->settings->terminated())
+        return false;
+
+    Check *check = queue->jobs[job].first;
+    ErrorQueue::Buffer *buffer = new ErrorQueue::Buffer(queue->jobs[job].second);
+    const long start = milliseconds();
+    if (queue->simplified)
+        check->runSimplifiedChecks(queue->tokenizer, queue->settings, buffer);
+    else
+        check->runChecks(queue->tokenizer, queue->settings, buffer);
+    queue->times[job] = milliseconds() - start;
+    queue->errors->push(buffer);
+    return true;
+}
+
+void *checkThread(void *arg)
+{
+    JobQueue *queue = static_cast<JobQueue *>(arg);
+    while (runJob(queue))
+    { }
+    return 0;
+}
+}
+#endif
+
+void CppCheck::runChecks(const Tokenizer &tokenizer, bool simplified)
+{
+#if defined(__GNUC__) && !defined(__MINGW32__)
+    if (_settings._checkThreads > 1)
+    {
+        ErrorQueue errors;
+
+        // The checks that can be run at the same time..
+        JobQueue queue;
+        queue.next = 0;
+        queue.simplified = simplified;
+        queue.tokenizer = &tokenizer;
+        queue.settings = &_settings;
+        queue.errors = &errors;
+
+        std::list<std::pair<Check *, unsigned int> > exclusive;
+        unsigned int sequence = 0;
+        for (std::list<Check *>::iterator it = Check::instances().begin(); it != Check::instances().end(); ++it, ++sequence)
+        {
+            if ((*it)->exclusive())
+                exclusive.push_back(std::make_pair(*it, sequence));
+            else
+                queue.jobs.push_back(std::make_pair(*it, sequence));
+        }
+        queue.times.resize(queue.jobs.size(), 0);
+
+        // The checks run at the same time => their names are not reported
+        progress("check", _tokenCount);
+
+        // This thread is one of the workers
+        std::vector<pthread_t> threads;
+        for (unsigned int i = 1; i < _settings._checkThreads && i < queue.jobs.size(); ++i)
+        {
+            pthread_t thread;
+            if (pthread_create(&thread, 0, checkThread, &queue) != 0)
+                break;
+            threads.push_back(thread);
+        }
+
+        // Report the messages as soon as the checks in front are ready
+        while (runJob(&queue))
+            errors.flush(*this);
+
+        for (unsigned int i = 0; i < threads.size(); ++i)
+            pthread_join(threads[i], 0);
+        errors.flush(*this);
+
+        // The exclusive checks are run alone
+        std::vector<long> times(sequence, 0);
+        for (std::list<std::pair<Check *, unsigned int> >::iterator it = exclusive.begin(); it != exclusive.end() && !_settings.terminated(); ++it)
+        {
+            progress("check " + it->first->name(), _tokenCount);
+            ErrorQueue::Buffer *buffer = new ErrorQueue::Buffer(it->second);
+            const long start = milliseconds();
+            if (simplified)
+                it->first->runSimplifiedChecks(&tokenizer, &_settings, buffer);
+            else
+                it->first->runChecks(&tokenizer, &_settings, buffer);
+            times[it->second] = milliseconds() - start;
+            errors.push(buffer);
+            errors.flush(*this);
+        }
+
+        // The wall times of the checks, in the same order as when the
+        // checks are run one after another
+        if (simplified && _settings._showtime)
+        {
+            for (unsigned int i = 0; i < queue.jobs.size(); ++i)
+                times[queue.jobs[i].second] = queue.times[i];
+            sequence = 0;
+            for (std::list<Check *>::iterator it = Check::instances().begin(); it != Check::instances().end(); ++it, ++sequence)
+                std::cout << (*it)->name() << "::runSimplifiedChecks: " << times[sequence] << std::endl;
+        }
+        return;
+    }
+#endif
+
+    for (std::list<Check *>::iterator it = Check::instances().begin(); it != Check::instances().end() && !_settings.terminated(); ++it)
     {
+        progress("check " + (*it)->name(), _tokenCount);
+
+        if (!simplified)
+        {
+            (*it)->runChecks(&tokenizer, &_settings, this);
+            continue;
+        }
+
 #ifdef __GNUC__
         clock_t c1 = clock();
-        (*it)->runSimplifiedChecks(&_tokenizer, &_settings, this);
+        (*it)->runSimplifiedChecks(&tokenizer, &_settings, this);
         clock_t c2 = clock();
         if (_settings._showtime)
             std::cout << (*it)->name() << "::runSimplifiedChecks: " << ((c2 - c1) / 1000) << std::endl;
 #else
-        (*it)->runSimplifiedChecks(&_tokenizer, &_settings, this);
+        (*it)->runSimplifiedChecks(&tokenizer, &_settings, this);
 #endif
     }
 }
@@ -491,10 +1082,23 @@ Settings CppCheck::settings() const
     return _settings;
 }
 
+void CppCheck::terminate()
+{
+    _settings.terminate();
+}
+
+void CppCheck::progress(const std::string &stage, unsigned int value)
+{
+    _errorLogger->reportProgress(_progressFile, stage, _cfgIndex, _cfgCount, value);
+}
+
 //---------------------------------------------------------------------------
 
 void CppCheck::reportErr(const ErrorLogger::ErrorMessage &msg)
 {
+    if (_fileResults)
+        _fileResults->push_back(msg);
+
     std::string errmsg = msg.toText();
 
     // Alert only about unique errors
@@ -502,15 +1106,7 @@ void CppCheck::reportErr(const ErrorLogger::ErrorMessage &msg)
         return;
 
     _errorList.push_back(errmsg);
-    std::string errmsg2(errmsg);
-    if (_settings._verbose)
-    {
-        errmsg2 += "\n    Defines=\'" + cfg + "\'\n";
-    }
-
     _errorLogger->reportErr(msg);
-
-    _errout << errmsg2 << std::endl;
 }
 
 void CppCheck::reportOut(const std::string &outmsg)
@@ -518,8 +1114,29 @@ void CppCheck::reportOut(const std::string &outmsg)
     _errorLogger->reportOut(outmsg);
 }
 
-const std::vector<std::string> &CppCheck::filenames() const
+void CppCheck::fileCache(FileCache *fileCache)
+{
+    _fileCache = fileCache;
+}
+
+void CppCheck::fileReader(FileReader *fileReader)
+{
+    _fileReader = fileReader;
+}
+
+void CppCheck::collectUnusedFunctions()
+{
+    _reportUnusedFunctions = false;
+}
+
+void CppCheck::writeUnusedFunctions(std::ostream &ostr) const
+{
+    _checkUnusedFunctions.writeSummary(ostr);
+}
+
+const std::vector<std::string> &CppCheck::filenames()
 {
+    addPaths();
     return _filenames;
 }
 
@@ -28,6 +28,10 @@
 #include "errorlogger.h"
 #include "checkunusedfunctions.h"
 
+class Tokenizer;
+class FileCache;
+class FileReader;
+
 /// @addtogroup Core
 /// @{
 
@@ -78,7 +82,9 @@ public:
      * e.g. "cppcheck.cpp". Note that only source files (.c, .cc or .cpp)
      * should be added to the list. Include files are gathered automatically.
      * You can also give path, e.g. "src/" which will be scanned for source
-     * files recursively.
+     * files recursively. The path is searched when check() or filenames()
+     * is called. If a FileReader is used then, see fileReader(), the path
+     * is a file that is read through it and the file system is not searched.
      */
     void addFile(const std::string &path);
 
@@ -96,6 +102,27 @@ public:
      */
     void clearFiles();
 
+    /**
+     * Write the function summary of a file into the summary directory,
+     * see Settings::_summaryDir. If the file has not changed since the
+     * summary was written, the old summary is kept.
+     * @param filename the source file
+     */
+    void createSummary(const std::string &filename);
+
+    /**
+     * Read the function summaries of all added files into the settings.
+     */
+    void loadSummaries();
+
+    /**
+     * Write the summaries of all added files with createSummary() and
+     * read them with loadSummaries(). check() calls this the first time
+     * it is called when Settings::_summaryDir is given, the later calls
+     * use the same summaries.
+     */
+    void createSummaries();
+
     /**
      * Parse command line args and get settings and file lists
      * from there.
@@ -109,13 +136,71 @@ public:
      */
     std::string parseFromArgs(int argc, const char* const argv[]);
 
-    const std::vector<std::string> &filenames() const;
+    /**
+     * Don't report unused functions in check(). The usage of the global
+     * functions is still collected if Settings::_unusedFunctions is set,
+     * and the caller can merge it with the usage in other files, see
+     * writeUnusedFunctions().
+     */
+    void collectUnusedFunctions();
+
+    /**
+     * Write the declarations and usage of the global functions in the
+     * checked files, see CheckUnusedFunctions::writeSummary()
+     * @param ostr the summary is written here
+     */
+    void writeUnusedFunctions(std::ostream &ostr) const;
+
+    /**
+     * Read the included files through a cache and keep the results of
+     * the checked files in it, see FileCache. The cache is not owned.
+     * @param fileCache the cache, or 0 if nothing is cached
+     */
+    void fileCache(FileCache *fileCache);
+
+    /**
+     * Read the checked files and the included files through a FileReader
+     * instead of the file system. The files that are added with
+     * addFile(path, content) are not read. The reader is not owned.
+     * @param fileReader the reader, or 0 if the files are read from the
+     * file system
+     */
+    void fileReader(FileReader *fileReader);
+
+    /**
+     * Stop the checking, see Settings::terminate(). This is called from
+     * another thread while check() is running. The results of the file
+     * that is checked when this is called are not cached.
+     */
+    void terminate();
+
+    /** The files to check, the paths given to addFile(path) are searched first */
+    const std::vector<std::string> &filenames();
 
     virtual void reportStatus(unsigned int index, unsigned int max);
 
 private:
     void checkFile(const std::string &code, const char FileName[]);
 
+    /** Add the files in the paths given to addFile(path) to _filenames */
+    void addPaths();
+
+    /**
+     * Report the progress in the current configuration of the file,
+     * see ErrorLogger::reportProgress()
+     */
+    void progress(const std::string &stage, unsigned int value);
+
+    /** The name of the file where the summary of a source file is saved */
+    std::string summaryFileName(const std::string &filename) const;
+
+    /**
+     * Run the checks of all registered Check classes
+     * @param tokenizer the tokenizer with the token list to check
+     * @param simplified true => runSimplifiedChecks, false => runChecks
+     */
+    void runChecks(const Tokenizer &tokenizer, bool simplified);
+
     /**
      * Errors and warnings are directed here.
      *
@@ -133,17 +218,41 @@ private:
     virtual void reportOut(const std::string &outmsg);
 
     std::list<std::string> _errorList;
-    std::ostringstream _errout;
     Settings _settings;
     std::vector<std::string> _filenames;
+    /** The paths given to addFile(path) that are not searched yet, see addPaths() */
+    std::vector<std::string> _paths;
     /** Key is file name, and value is the content of the file */
     std::map<std::string, std::string> _fileContents;
     CheckUnusedFunctions _checkUnusedFunctions;
     ErrorLogger *_errorLogger;
 
+    /** Report the unused functions at the end of check(), see collectUnusedFunctions() */
+    bool _reportUnusedFunctions;
+
+    /** Have the summaries been read, see createSummaries() */
+    bool _summariesLoaded;
+
+    /** Cache for the included files and the results, see fileCache() */
+    FileCache *_fileCache;
+
+    /** The files are read through this, see fileReader() */
+    FileReader *_fileReader;
+
+    /** The errors of the file that is checked are saved here when they are cached */
+    std::list<ErrorLogger::ErrorMessage> *_fileResults;
+
     /** Current configuration */
     std::string     cfg;
 
+    /** The file that is checked and its configurations, see progress() */
+    std::string _progressFile;
+    unsigned int _cfgIndex;
+    unsigned int _cfgCount;
+
+    /** The number of tokens in the token list that is checked */
+    unsigned int _tokenCount;
+
     std::list<std::string> _xmllist;
 };
 
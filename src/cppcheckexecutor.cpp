@@ -19,11 +19,14 @@
 #include "cppcheckexecutor.h"
 #include "cppcheck.h"
 #include "threadexecutor.h"
+#include "reportwriter.h"
+#include "daemon.h"
 #include <fstream>
 #include <iostream>
 #include <cstdlib> // EXIT_SUCCESS and EXIT_FAILURE
 
 CppCheckExecutor::CppCheckExecutor()
+        : _reportWriter(0)
 {
 
 }
@@ -40,11 +43,32 @@ int CppCheckExecutor::check(int argc, const char* const argv[])
     if (result.length() == 0)
     {
         _settings = cppCheck.settings();
-        if (_settings._xml)
+
+        if (!_settings._daemon.empty())
         {
-            reportErr(ErrorLogger::ErrorMessage::getXMLHeader());
+            if (!Daemon::isEnabled())
+            {
+                std::cout << "No daemon support yet implemented for this platform." << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            // The summaries of the given files are made once, and the
+            // daemon checks the files with them
+            if (!_settings._summaryDir.empty())
+            {
+                cppCheck.createSummaries();
+                _settings = cppCheck.settings();
+                _settings._summaryDir = "";
+            }
+
+            Daemon daemon(_settings);
+            return daemon.run();
         }
 
+        ReportWriter reportWriter(std::cerr, _settings._xml);
+        _reportWriter = &reportWriter;
+        reportWriter.writeHeader();
+
         unsigned int returnValue = 0;
         if (_settings._jobs == 1)
         {
@@ -64,10 +88,9 @@ int CppCheckExecutor::check(int argc, const char* const argv[])
             returnValue = executor.check();
         }
 
-        if (_settings._xml)
-        {
-            reportErr(ErrorLogger::ErrorMessage::getXMLFooter());
-        }
+        reportWriter.writeFooter();
+        reportWriter.flush();
+        _reportWriter = 0;
 
         if (returnValue)
             return _settings._exitCode;
@@ -81,18 +104,20 @@ int CppCheckExecutor::check(int argc, const char* const argv[])
     }
 }
 
-void CppCheckExecutor::reportErr(const std::string &errmsg)
-{
-    std::cerr << errmsg << std::endl;
-}
-
 void CppCheckExecutor::reportOut(const std::string &outmsg)
 {
+    // Write the errors found so far first so the output stays in order
+    if (_reportWriter)
+        _reportWriter->flush();
     std::cout << outmsg << std::endl;
 }
 
 void CppCheckExecutor::reportStatus(unsigned int index, unsigned int max)
 {
+    // A file has been checked => write its errors, also with --quiet
+    if (_reportWriter)
+        _reportWriter->flush();
+
     if (max > 1 && !_settings._errorsOnly)
     {
         std::ostringstream oss;
@@ -104,14 +129,24 @@ void CppCheckExecutor::reportStatus(unsigned int index, unsigned int max)
     }
 }
 
-void CppCheckExecutor::reportErr(const ErrorLogger::ErrorMessage &msg)
+void CppCheckExecutor::reportProgress(const std::string &filename, const std::string &stage, unsigned int cfg, unsigned int cfgCount, unsigned int value)
 {
-    if (_settings._xml)
+    if (_settings._progress && !_settings._errorsOnly)
     {
-        reportErr(msg.toXML());
+        if (_reportWriter)
+            _reportWriter->flush();
+
+        const bool bytes = (stage == "preprocess" || stage == "tokenize");
+        std::cout << filename << ": configuration " << cfg << "/" << cfgCount
+        << ", " << stage << " (" << value << (bytes ? " bytes" : " tokens") << ")"
+        << std::endl;
     }
+}
+
+void CppCheckExecutor::reportErr(const ErrorLogger::ErrorMessage &msg)
+{
+    if (_reportWriter)
+        _reportWriter->write(msg);
     else
-    {
-        reportErr(msg.toText());
-    }
+        std::cerr << (_settings._xml ? msg.toXML() : msg.toText()) << std::endl;
 }
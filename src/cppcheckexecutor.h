@@ -22,6 +22,8 @@
 #include "errorlogger.h"
 #include "settings.h"
 
+class ReportWriter;
+
 /**
  * This class works as an example of how CppCheck can be used in external
  * programs without very little knowledge of the internal parts of the
@@ -68,15 +70,15 @@ public:
 
     virtual void reportStatus(unsigned int index, unsigned int max);
 
-private:
+    /** Print the progress in the file if --progress is given */
+    virtual void reportProgress(const std::string &filename, const std::string &stage, unsigned int cfg, unsigned int cfgCount, unsigned int value);
 
-    /**
-     * Helper function to print out errors. Appends a line change.
-     * @param errmsg String printed to error stream
-     */
-    void reportErr(const std::string &errmsg);
+private:
 
     Settings _settings;
+
+    /** The errors are written here while the files are checked */
+    ReportWriter *_reportWriter;
 };
 
 #endif // CPPCHECKEXECUTOR_H
@@ -0,0 +1,239 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2009 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#include "daemon.h"
+#include "cppcheck.h"
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <cstdlib>
+#if defined(__GNUC__) && !defined(__MINGW32__)
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <csignal>
+#include <cerrno>
+#include <cstring>
+#include <cstdio>
+#endif
+
+Daemon::Daemon(const Settings &settings)
+        : _settings(settings), _client(-1), _errorCount(0)
+{
+
+}
+
+Daemon::~Daemon()
+{
+
+}
+
+void Daemon::reportOut(const std::string &/*outmsg*/)
+{
+    // The progress is not written to the client
+}
+
+void Daemon::reportErr(const ErrorLogger::ErrorMessage &msg)
+{
+    ++_errorCount;
+    writeLine(_settings._xml ? msg.toXML() : msg.toText());
+}
+
+void Daemon::reportStatus(unsigned int /*index*/, unsigned int /*max*/)
+{
+    // The progress is not written to the client
+}
+
+void Daemon::handleCommand(const std::string &command)
+{
+    if (command.compare(0, 6, "check ") == 0)
+    {
+        _errorCount = 0;
+
+        const std::string path(command.substr(6));
+        CppCheck cppCheck(*this);
+        cppCheck.settings(_settings);
+        cppCheck.fileCache(&_fileCache);
+        cppCheck.addFile(path);
+
+        // No files are found in a missing path
+        if (cppCheck.filenames().empty() && !std::ifstream(path.c_str()))
+        {
+            writeLine("error can't read \"" + path + "\"");
+            return;
+        }
+
+        cppCheck.check();
+
+        std::ostringstream done;
+        done << "done " << _errorCount;
+        writeLine(done.str());
+    }
+    else if (!command.empty())
+    {
+        writeLine("error unknown command \"" + command + "\"");
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+////// This code is for __GNUC__ only /////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+#if defined(__GNUC__) && !defined(__MINGW32__)
+
+int Daemon::run()
+{
+    const std::string &path = _settings._daemon;
+
+    // Write errors of a closed connection are handled where they happen
+    signal(SIGPIPE, SIG_IGN);
+
+    struct sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.length() >= sizeof(address.sun_path))
+    {
+        std::cerr << "cppcheck: the path of the socket is too long: " << path << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::strcpy(address.sun_path, path.c_str());
+
+    const int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server < 0)
+    {
+        perror("socket");
+        return EXIT_FAILURE;
+    }
+
+    // The socket of a daemon that was not shut down is still there.
+    // Don't remove anything else.
+    struct stat file_stat;
+    if (lstat(path.c_str(), &file_stat) == 0)
+    {
+        if (!S_ISSOCK(file_stat.st_mode))
+        {
+            std::cerr << "cppcheck: the path of the socket exists and is not a socket: " << path << std::endl;
+            close(server);
+            return EXIT_FAILURE;
+        }
+        unlink(path.c_str());
+    }
+
+    if (bind(server, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) < 0 ||
+        listen(server, 5) < 0)
+    {
+        perror("bind");
+        close(server);
+        return EXIT_FAILURE;
+    }
+
+    if (_settings._errorsOnly == false)
+        std::cout << "Listening on " << path << std::endl;
+
+    bool shutdown = false;
+    while (!shutdown)
+    {
+        _client = accept(server, 0, 0);
+        if (_client < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            perror("accept");
+            break;
+        }
+
+        shutdown = handleClient();
+        close(_client);
+        _client = -1;
+    }
+
+    close(server);
+    unlink(path.c_str());
+    return EXIT_SUCCESS;
+}
+
+bool Daemon::handleClient()
+{
+    std::string buffer;
+    char data[4096];
+    for (;;)
+    {
+        // Handle the complete lines..
+        std::string::size_type newline;
+        while ((newline = buffer.find('\n')) != std::string::npos)
+        {
+            std::string command(buffer.substr(0, newline));
+            buffer.erase(0, newline + 1);
+            if (!command.empty() && command[command.length()-1] == '\r')
+                command.erase(command.length() - 1);
+
+            if (command == "shutdown")
+                return true;
+            handleCommand(command);
+        }
+
+        // ..and read more
+        const ssize_t len = read(_client, data, sizeof(data));
+        if (len < 0 && errno == EINTR)
+            continue;
+        if (len <= 0)
+            return false;
+        buffer.append(data, len);
+    }
+}
+
+void Daemon::writeLine(const std::string &line)
+{
+    if (_client < 0)
+        return;
+
+    const std::string data(line + "\n");
+    std::string::size_type pos = 0;
+    while (pos < data.length())
+    {
+        const ssize_t len = write(_client, data.c_str() + pos, data.length() - pos);
+        if (len < 0 && errno == EINTR)
+            continue;
+
+        // The client has closed the connection
+        if (len <= 0)
+            return;
+        pos += len;
+    }
+}
+
+#else
+
+int Daemon::run()
+{
+    return EXIT_FAILURE;
+}
+
+bool Daemon::handleClient()
+{
+    return true;
+}
+
+void Daemon::writeLine(const std::string &/*line*/)
+{
+
+}
+
+#endif
@@ -0,0 +1,106 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2009 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef DAEMON_H
+#define DAEMON_H
+
+#include <string>
+#include "settings.h"
+#include "errorlogger.h"
+#include "filecache.h"
+
+/**
+ * @brief Check files on request. The requests are read from a local
+ * socket, and the included files and the results are kept in a FileCache
+ * between the requests.
+ *
+ * The client writes one command per line:
+ * - "check path" checks a file or the source files in a directory. Each
+ *   error is written back on its own line in text or xml format, see
+ *   Settings::_xml, and then "done n" where n is the number of errors.
+ *   If the path can't be read, "error can't read "path"" is written back.
+ * - "shutdown" stops the daemon.
+ */
+class Daemon : public ErrorLogger
+{
+public:
+    /**
+     * @param settings the settings of the checks, Settings::_daemon is
+     * the path of the socket
+     */
+    Daemon(const Settings &settings);
+    virtual ~Daemon();
+
+    /**
+     * Listen to the socket and handle the requests until the daemon is
+     * shut down.
+     * @return EXIT_SUCCESS after shutdown, EXIT_FAILURE if the socket
+     * can't be created or if something else than a socket exists in its path
+     */
+    int run();
+
+    virtual void reportOut(const std::string &outmsg);
+    virtual void reportErr(const ErrorLogger::ErrorMessage &msg);
+    virtual void reportStatus(unsigned int index, unsigned int max);
+
+private:
+    /**
+     * Handle the commands of a client until it closes the connection
+     * @return true if the daemon is shut down
+     */
+    bool handleClient();
+
+    /** Handle a command other than "shutdown" */
+    void handleCommand(const std::string &command);
+
+    /** Write a line to the client */
+    void writeLine(const std::string &line);
+
+    Settings _settings;
+
+    /** The included files and the results of the checked files */
+    FileCache _fileCache;
+
+    /** The connection to the client, or -1 */
+    int _client;
+
+    /** The number of errors found by the current command */
+    unsigned int _errorCount;
+
+#if defined(__GNUC__) && !defined(__MINGW32__)
+public:
+    /**
+     * @return true if the daemon is supported on this platform
+     */
+    static bool isEnabled()
+    {
+        return true;
+    }
+#else
+public:
+    /**
+     * @return true if the daemon is supported on this platform
+     */
+    static bool isEnabled()
+    {
+        return false;
+    }
+#endif
+};
+
+#endif // DAEMON_H
@@ -124,49 +124,92 @@ std::string ErrorLogger::ErrorMessage::getXMLFooter()
     return "</results>";
 }
 
-std::string ErrorLogger::ErrorMessage::toXML() const
+namespace
 {
-    std::ostringstream xml;
-    xml << "<error";
-    if (!_callStack.empty())
+/** Append an unsigned integer to a string */
+void appendNumber(std::string &str, unsigned int value)
+{
+    char buf[16];
+    char *p = buf + sizeof(buf);
+    do
     {
-        xml << " file=\"" << _callStack.back().getfile() << "\"";
-        xml << " line=\"" << _callStack.back().line << "\"";
+        *(--p) = static_cast<char>('0' + value % 10);
+        value /= 10;
     }
-    xml << " id=\"" << _id << "\"";
-    xml << " severity=\"" << _severity << "\"";
+    while (value > 0);
+    str.append(p, buf + sizeof(buf));
+}
 
-    // Replace characters in message
-    std::string m(_msg);
-    std::string::size_type pos = 0;
-    while ((pos = m.find_first_of("<>&\"", pos)) != std::string::npos)
+/** Append a string to xml, replacing the special characters */
+void appendEscaped(std::string &xml, const std::string &str)
+{
+    std::string::size_type start = 0;
+    std::string::size_type pos;
+    while ((pos = str.find_first_of("<>&\"", start)) != std::string::npos)
     {
-        if (m[pos] == '<')
-            m.insert(pos + 1, "&lt;");
-        else if (m[pos] == '>')
-            m.insert(pos + 1, "&gt;");
-        else if (m[pos] == '&')
-            m.insert(pos + 1, "&amp;");
-        else if (m[pos] == '"')
-            m.insert(pos + 1, "&quot;");
-        m.erase(pos, 1);
-        ++pos;
+        xml.append(str, start, pos - start);
+        if (str[pos] == '<')
+            xml += "&lt;";
+        else if (str[pos] == '>')
+            xml += "&gt;";
+        else if (str[pos] == '&')
+            xml += "&amp;";
+        else
+            xml += "&quot;";
+        start = pos + 1;
     }
+    xml.append(str, start, std::string::npos);
+}
+}
 
-    xml << " msg=\"" << m << "\"";
-    xml << "/>";
-    return xml.str();
+std::string ErrorLogger::ErrorMessage::toXML() const
+{
+    std::string xml;
+    toXML(xml);
+    return xml;
+}
+
+void ErrorLogger::ErrorMessage::toXML(std::string &xml) const
+{
+    xml += "<error";
+    if (!_callStack.empty())
+    {
+        xml += " file=\"";
+        xml += _callStack.back().getfile();
+        xml += "\" line=\"";
+        appendNumber(xml, _callStack.back().line);
+        xml += "\"";
+    }
+    xml += " id=\"";
+    xml += _id;
+    xml += "\" severity=\"";
+    xml += _severity;
+    xml += "\" msg=\"";
+    appendEscaped(xml, _msg);
+    xml += "\"/>";
 }
 
 std::string ErrorLogger::ErrorMessage::toText() const
 {
-    std::ostringstream text;
+    std::string text;
+    toText(text);
+    return text;
+}
+
+void ErrorLogger::ErrorMessage::toText(std::string &text) const
+{
     if (!_callStack.empty())
-        text << callStackToString(_callStack) << ": ";
+    {
+        text += callStackToString(_callStack);
+        text += ": ";
+    }
     if (!_severity.empty())
-        text << "(" << _severity << ") ";
-    text << _msg;
-    return text.str();
+    {
+        text += "(";
+        text += _severity;
+        text += ") ";
+    }
+    text += _msg;
 }
 
 void ErrorLogger::_writemsg(const Tokenizer *tokenizer, const Token *tok, const char severity[], const std::string &msg, const std::string &id)
@@ -63,10 +63,23 @@ public:
         ErrorMessage();
         std::string toXML() const;
 
+        /**
+         * Append the message in xml format to a string. Nothing is
+         * allocated except what the string needs to grow.
+         * @param xml the string where the message is appended
+         */
+        void toXML(std::string &xml) const;
+
         static std::string getXMLHeader();
         static std::string getXMLFooter();
 
         std::string toText() const;
+
+        /**
+         * Append the message in text format to a string.
+         * @param text the string where the message is appended
+         */
+        void toText(std::string &text) const;
         std::string serialize() const;
         bool deserialize(const std::string &data);
         std::list<FileLocation> _callStack;
@@ -103,6 +116,22 @@ public:
      */
     virtual void reportStatus(unsigned int index, unsigned int max) = 0;
 
+    /**
+     * Information about the progress in the file that is checked. This
+     * is reported when a phase of the checking starts. Override this to
+     * receive the progress, by default it is ignored.
+     *
+     * @param filename The file that is checked.
+     * @param stage The phase: "preprocess", "tokenize", "simplify",
+     * "match" or "check" followed by the name of the check.
+     * @param cfg The configuration that is checked, starting from 1.
+     * @param cfgCount This many configurations are checked in the file.
+     * @param value The amount of code that the phase handles: bytes for
+     * "preprocess" and "tokenize" and tokens for the other phases.
+     */
+    virtual void reportProgress(const std::string &/*filename*/, const std::string &/*stage*/, unsigned int /*cfg*/, unsigned int /*cfgCount*/, unsigned int /*value*/)
+    { }
+
 
     static bool arrayIndexOutOfBounds(const Settings &s)
     {
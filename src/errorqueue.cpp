@@ -0,0 +1,124 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2009 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#include "errorqueue.h"
+
+//---------------------------------------------------------------------------
+
+ErrorQueue::Buffer::Buffer(unsigned int sequence)
+        : _sequence(sequence), _next(0)
+{
+
+}
+
+void ErrorQueue::Buffer::report(ErrorLogger &errorLogger) const
+{
+    std::list<std::string>::const_iterator out = _out.begin();
+    std::list<ErrorLogger::ErrorMessage>::const_iterator err = _err.begin();
+    for (std::list<bool>::const_iterator it = _order.begin(); it != _order.end(); ++it)
+    {
+        if (*it)
+            errorLogger.reportErr(*(err++));
+        else
+            errorLogger.reportOut(*(out++));
+    }
+}
+
+void ErrorQueue::Buffer::reportOut(const std::string &outmsg)
+{
+    _order.push_back(false);
+    _out.push_back(outmsg);
+}
+
+void ErrorQueue::Buffer::reportErr(const ErrorLogger::ErrorMessage &msg)
+{
+    _order.push_back(true);
+    _err.push_back(msg);
+}
+
+//---------------------------------------------------------------------------
+
+ErrorQueue::ErrorQueue()
+        : _head(0), _nextSequence(0)
+{
+
+}
+
+ErrorQueue::~ErrorQueue()
+{
+    Buffer *buffer = _head;
+    while (buffer)
+    {
+        Buffer *next = buffer->_next;
+        delete buffer;
+        buffer = next;
+    }
+
+    for (std::map<unsigned int, Buffer *>::iterator it = _pending.begin(); it != _pending.end(); ++it)
+        delete it->second;
+}
+
+void ErrorQueue::push(Buffer *buffer)
+{
+#ifdef __GNUC__
+    // Put the buffer first in the list. Retry if another thread
+    // changed the head in between. The head is read atomically too,
+    // flush() swaps it in another thread.
+    Buffer *head;
+    do
+    {
+        head = __sync_val_compare_and_swap(&_head, static_cast<Buffer *>(0), static_cast<Buffer *>(0));
+        buffer->_next = head;
+    }
+    while (!__sync_bool_compare_and_swap(&_head, head, buffer));
+#else
+    buffer->_next = _head;
+    _head = buffer;
+#endif
+}
+
+unsigned int ErrorQueue::flush(ErrorLogger &errorLogger)
+{
+    // Take all the pushed buffers at once
+#ifdef __GNUC__
+    Buffer *buffer = __sync_lock_test_and_set(&_head, static_cast<Buffer *>(0));
+#else
+    Buffer *buffer = _head;
+    _head = 0;
+#endif
+
+    while (buffer)
+    {
+        _pending[buffer->_sequence] = buffer;
+        buffer = buffer->_next;
+    }
+
+    // Report the buffers that are next in order
+    unsigned int count = 0;
+    std::map<unsigned int, Buffer *>::iterator it = _pending.begin();
+    while (it != _pending.end() && it->first == _nextSequence)
+    {
+        it->second->report(errorLogger);
+        delete it->second;
+        _pending.erase(it++);
+        ++_nextSequence;
+        ++count;
+    }
+    return count;
+}
+
@@ -0,0 +1,124 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2009 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/
+ */
+
+//---------------------------------------------------------------------------
+#ifndef errorqueueH
+#define errorqueueH
+//---------------------------------------------------------------------------
+
+#include <list>
+#include <map>
+#include <string>
+#include "errorlogger.h"
+
+/// @addtogroup Core
+/// @{
+
+/**
+ * @brief Collect the messages of several threads and report them in order.
+ *
+ * Each producer writes its messages into its own Buffer, so nothing is
+ * shared while the messages are written. A finished buffer is handed to
+ * the queue with push(), which is lock free and can be called from any
+ * thread. The consumer calls flush() which reports the buffers in the
+ * order of their sequence numbers. A buffer that is pushed before the
+ * buffers in front of it is kept until they have been reported, so the
+ * output is always the same no matter how the threads are scheduled.
+ */
+class ErrorQueue
+{
+public:
+    /** @brief The messages of one producer */
+    class Buffer : public ErrorLogger
+    {
+    public:
+        /**
+         * @param sequence the position of this buffer in the output.
+         * The first buffer has sequence 0.
+         */
+        explicit Buffer(unsigned int sequence);
+
+        unsigned int sequence() const
+        {
+            return _sequence;
+        }
+
+        /** report the saved messages in the order they were written */
+        void report(ErrorLogger &errorLogger) const;
+
+        void reportOut(const std::string &outmsg);
+        void reportErr(const ErrorLogger::ErrorMessage &msg);
+        void reportStatus(unsigned int, unsigned int)
+        { }
+
+    private:
+        friend class ErrorQueue;
+
+        const unsigned int _sequence;
+
+        /** next buffer in the queue */
+        Buffer *_next;
+
+        /** order of the messages, true => error, false => output */
+        std::list<bool> _order;
+        std::list<std::string> _out;
+        std::list<ErrorLogger::ErrorMessage> _err;
+    };
+
+    ErrorQueue();
+
+    /** Deletes the buffers that have not been flushed */
+    ~ErrorQueue();
+
+    /**
+     * Hand a finished buffer to the queue. The queue takes the ownership
+     * of the buffer. This can be called from any thread.
+     */
+    void push(Buffer *buffer);
+
+    /**
+     * Report the buffers that are next in order. Only one thread may
+     * call this.
+     * @return number of buffers that were reported
+     */
+    unsigned int flush(ErrorLogger &errorLogger);
+
+    /** The sequence number of the next buffer that will be reported */
+    unsigned int next() const
+    {
+        return _nextSequence;
+    }
+
+private:
+    /** Buffers that have been pushed but not yet seen by flush() */
+    Buffer * volatile _head;
+
+    /** Buffers that wait for the buffers in front of them */
+    std::map<unsigned int, Buffer *> _pending;
+
+    unsigned int _nextSequence;
+
+    /** Not copyable */
+    ErrorQueue(const ErrorQueue &);
+    ErrorQueue &operator=(const ErrorQueue &);
+};
+
+/// @}
+//---------------------------------------------------------------------------
+#endif
+
@@ -0,0 +1,126 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2009 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/
+ */
+
+//---------------------------------------------------------------------------
+#include "filecache.h"
+#include "preprocessor.h"
+
+#include <fstream>
+#include <sstream>
+#include <sys/types.h>
+#include <sys/stat.h>
+//---------------------------------------------------------------------------
+
+FileCache::FileCache(std::string::size_type maxSize)
+    : _size(0), _maxSize(maxSize), _useCount(0)
+{
+
+}
+
+bool FileCache::read(const std::string &filename, std::string &code)
+{
+    struct stat file_stat;
+    if (stat(filename.c_str(), &file_stat) != 0)
+        return false;
+
+    // A file can be changed several times in a second
+#ifdef __linux__
+    const long modifiedNsec = static_cast<long>(file_stat.st_mtim.tv_nsec);
+#else
+    const long modifiedNsec = 0;
+#endif
+
+    std::map<std::string, File>::iterator it = _files.find(filename);
+    if (it != _files.end() &&
+        it->second.modified == static_cast<long>(file_stat.st_mtime) &&
+        it->second.modifiedNsec == modifiedNsec &&
+        it->second.size == static_cast<long>(file_stat.st_size))
+    {
+        it->second.used = ++_useCount;
+        code = it->second.code;
+        return true;
+    }
+
+    std::ifstream fin(filename.c_str());
+    if (!fin.is_open())
+        return false;
+
+    File &file = _files[filename];
+    _size -= file.code.size();
+    file.modified = static_cast<long>(file_stat.st_mtime);
+    file.modifiedNsec = modifiedNsec;
+    file.size = static_cast<long>(file_stat.st_size);
+    file.code = Preprocessor::read(fin);
+    file.used = ++_useCount;
+    _size += file.code.size();
+    code = file.code;
+    evict();
+    return true;
+}
+
+void FileCache::evict()
+{
+    while (_size > _maxSize && !_files.empty())
+    {
+        std::map<std::string, File>::iterator oldest = _files.begin();
+        for (std::map<std::string, File>::iterator it = _files.begin(); it != _files.end(); ++it)
+        {
+            if (it->second.used < oldest->second.used)
+                oldest = it;
+        }
+        _size -= oldest->second.code.size();
+        _files.erase(oldest);
+    }
+}
+
+const std::list<ErrorLogger::ErrorMessage> *FileCache::results(const std::string &filename, const std::string &code) const
+{
+    std::map<std::string, Results>::const_iterator it = _results.find(filename);
+    if (it == _results.end() || it->second.digest != digest(code))
+        return 0;
+    return &it->second.messages;
+}
+
+void FileCache::results(const std::string &filename, const std::string &code, const std::list<ErrorLogger::ErrorMessage> &messages)
+{
+    Results &results = _results[filename];
+    results.digest = digest(code);
+    results.messages = messages;
+}
+
+void FileCache::clear()
+{
+    _files.clear();
+    _results.clear();
+    _size = 0;
+}
+
+std::string FileCache::digest(const std::string &code)
+{
+    // FNV-1a hash of the code
+    unsigned long hash = 2166136261UL;
+    for (std::string::size_type i = 0; i < code.size(); ++i)
+    {
+        hash ^= static_cast<unsigned char>(code[i]);
+        hash = (hash * 16777619UL) & 0xffffffffUL;
+    }
+
+    std::ostringstream ostr;
+    ostr << std::hex << hash << " " << std::dec << code.size();
+    return ostr.str();
+}
@@ -0,0 +1,135 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2009 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/
+ */
+
+//---------------------------------------------------------------------------
+#ifndef filecacheH
+#define filecacheH
+//---------------------------------------------------------------------------
+
+#include <list>
+#include <map>
+#include <string>
+#include "errorlogger.h"
+
+/// @addtogroup Core
+/// @{
+
+/**
+ * @brief Keep the included files and the results of the checks between
+ * the checks, so that the files that have not changed are not read or
+ * checked again. This is used by the Daemon.
+ *
+ * An included file is read again when its modification time or size has
+ * changed. The results of a source file are used again when the source
+ * file and the files it includes are the same as when it was checked;
+ * only a digest of the code is kept for that. The code of the files that
+ * have been read is kept up to a maximum size, after that the files that
+ * have not been used for the longest time are forgotten.
+ */
+class FileCache
+{
+public:
+    /**
+     * @param maxSize the maximum size of the code of the files that are
+     * kept, in bytes
+     */
+    explicit FileCache(std::string::size_type maxSize = 64 * 1024 * 1024);
+
+    /**
+     * Read a file. If the file has not changed since it was last read,
+     * the code that was read then is returned.
+     * @param filename the file
+     * @param code the code, as Preprocessor::read() gives it
+     * @return false if the file can't be read
+     */
+    bool read(const std::string &filename, std::string &code);
+
+    /**
+     * Get the results of a source file.
+     * @param filename the source file
+     * @param code the source file with the included files, as
+     * Preprocessor::preprocess() gives it
+     * @return the error messages, or 0 if the file has not been checked
+     * or the code has changed since it was checked
+     */
+    const std::list<ErrorLogger::ErrorMessage> *results(const std::string &filename, const std::string &code) const;
+
+    /**
+     * Save the results of a source file.
+     * @param filename the source file
+     * @param code the source file with the included files
+     * @param messages the error messages
+     */
+    void results(const std::string &filename, const std::string &code, const std::list<ErrorLogger::ErrorMessage> &messages);
+
+    /** Forget all the files and results */
+    void clear();
+
+    /**
+     * The digest of some code: a hash and the size of the code
+     * @param code the code
+     * @return e.g. "811c9dc5 0"
+     */
+    static std::string digest(const std::string &code);
+
+private:
+    /** A file that has been read */
+    class File
+    {
+    public:
+        long modified;
+        long modifiedNsec;
+        long size;
+        std::string code;
+
+        /** When the file was last used, see _useCount */
+        unsigned long used;
+    };
+
+    /** The digest of the code and the error messages of a checked source file */
+    class Results
+    {
+    public:
+        std::string digest;
+        std::list<ErrorLogger::ErrorMessage> messages;
+    };
+
+    /** The files that have been read. The key is the file name. */
+    std::map<std::string, File> _files;
+
+    /** The size of the code of the files that are kept */
+    std::string::size_type _size;
+
+    /** The maximum size of the code of the files that are kept */
+    std::string::size_type _maxSize;
+
+    /** Counts the reads, to know which file was used the longest time ago */
+    unsigned long _useCount;
+
+    /** Forget the files that have not been used for the longest time,
+        until the code that is kept is not bigger than the maximum size */
+    void evict();
+
+    /** The results of the checked files. The key is the file name. */
+    std::map<std::string, Results> _results;
+};
+
+/// @}
+
+//---------------------------------------------------------------------------
+#endif
@@ -27,6 +27,8 @@
 #if defined(__GNUC__) && !defined(__MINGW32__)
 #include <glob.h>
 #include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
 #endif
 #if defined(__BORLANDC__) || defined(_MSC_VER) || defined(__MINGW32__)
 #include <windows.h>
@@ -109,27 +111,163 @@ bool FileLister::acceptFile(const std::string &filename)
     return false;
 }
 
+/** Match a string with a pattern that can contain '*' and '?' */
+static bool matchPattern(const char *pattern, const char *str)
+{
+    for (; *pattern; ++pattern, ++str)
+    {
+        if (*pattern == '*')
+        {
+            for (;;)
+            {
+                if (matchPattern(pattern + 1, str))
+                    return true;
+                if (*str == '\0')
+                    return false;
+                ++str;
+            }
+        }
+
+        if (*str == '\0' || (*pattern != '?' && *pattern != *str))
+            return false;
+    }
+    return (*str == '\0');
+}
+
+bool FileLister::excluded(const std::string &path, const std::list<std::string> &exclude)
+{
+    if (exclude.empty())
+        return false;
+
+    std::string filename(path);
+    while (filename.compare(0, 2, "./") == 0 || filename.compare(0, 2, ".\\") == 0)
+        filename.erase(0, 2);
+    while (filename.length() > 1 && (filename[filename.length()-1] == '/' || filename[filename.length()-1] == '\\'))
+        filename.erase(filename.length() - 1);
+
+    // Match the name..
+    const std::string::size_type slash = filename.find_last_of("/\\");
+    const std::string name(slash == std::string::npos ? filename : filename.substr(slash + 1));
+    for (std::list<std::string>::const_iterator it = exclude.begin(); it != exclude.end(); ++it)
+    {
+        if (matchPattern(it->c_str(), name.c_str()))
+            return true;
+    }
+
+    // Match the path and the paths of the parent directories..
+    std::string::size_type end = filename.length();
+    while (end != std::string::npos && end > 0)
+    {
+        const std::string subpath(filename.substr(0, end));
+        for (std::list<std::string>::const_iterator it = exclude.begin(); it != exclude.end(); ++it)
+        {
+            if (matchPattern(it->c_str(), subpath.c_str()))
+                return true;
+        }
+        end = subpath.find_last_of("/\\");
+    }
+
+    return false;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 ////// This code is for __GNUC__ only /////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
 #if defined(__GNUC__) && !defined(__MINGW32__)
 // gcc / cygwin..
-void FileLister::recursiveAddFiles(std::vector<std::string> &filenames, const std::string &path, bool recursive)
+
+static bool isDirectory(const std::string &path)
+{
+    struct stat file_stat;
+    return (stat(path.c_str(), &file_stat) == 0 && S_ISDIR(file_stat.st_mode));
+}
+
+/**
+ * Add the files in a directory. The file type that readdir() gives is
+ * used so that stat() is only called for symbolic links and when the file
+ * system doesn't tell the type.
+ * @param filenames the files are added here
+ * @param path the directory, ending with '/'
+ * @param recursive if true, the source files in the directory and its
+ * subdirectories are added. If false, every file in the directory is added.
+ * @param exclude the excluded files and directories
+ */
+static void addFilesInDirectory(std::vector<std::string> &filenames, const std::string &path, bool recursive, const std::list<std::string> &exclude)
+{
+    DIR *dir = opendir(path.c_str());
+    if (!dir)
+        return;
+
+    // The directories get a '/' at the end, so the entries are
+    // sorted in the same order as glob() with GLOB_MARK sorts them
+    std::vector<std::string> entries;
+    while (const struct dirent *entry = readdir(dir))
+    {
+        // Skip ".", ".." and the hidden files
+        if (entry->d_name[0] == '.')
+            continue;
+
+        const std::string filename(path + entry->d_name);
+
+        // Skip the excluded files and directories before reading them
+        if (FileLister::excluded(filename, exclude))
+            continue;
+
+        bool directory = false;
+#ifdef _DIRENT_HAVE_D_TYPE
+        if (entry->d_type == DT_DIR)
+            directory = true;
+        else if (entry->d_type == DT_LNK || entry->d_type == DT_UNKNOWN)
+            directory = isDirectory(filename);
+#else
+        directory = isDirectory(filename);
+#endif
+
+        if (directory)
+        {
+            if (recursive)
+                entries.push_back(filename + "/");
+        }
+        else if (!recursive || FileLister::acceptFile(filename))
+        {
+            entries.push_back(filename);
+        }
+    }
+    closedir(dir);
+
+    std::sort(entries.begin(), entries.end());
+    for (std::vector<std::string>::const_iterator it = entries.begin(); it != entries.end(); ++it)
+    {
+        if ((*it)[it->length()-1] == '/')
+            addFilesInDirectory(filenames, *it, recursive, exclude);
+        else
+            filenames.push_back(*it);
+    }
+}
+
+void FileLister::recursiveAddFiles(std::vector<std::string> &filenames, const std::string &path, bool recursive, const std::list<std::string> &exclude)
 {
-    std::ostringstream oss;
-    oss << path;
     if (path.length() > 0 && path[path.length()-1] == '/')
-        oss << "*";
+    {
+        // Directory
+        if (!FileLister::excluded(path, exclude))
+            addFilesInDirectory(filenames, path, recursive, exclude);
+        return;
+    }
 
+    // The path can be a pattern
     glob_t glob_results;
-    glob(oss.str().c_str(), GLOB_MARK, 0, &glob_results);
+    glob(path.c_str(), GLOB_MARK, 0, &glob_results);
     for (unsigned int i = 0; i < glob_results.gl_pathc; i++)
     {
         std::string filename = glob_results.gl_pathv[i];
         if (filename == "." || filename == ".." || filename.length() == 0)
             continue;
 
+        if (FileLister::excluded(filename, exclude))
+            continue;
+
         if (filename[filename.length()-1] != '/')
         {
             // File
@@ -141,7 +279,7 @@ void FileLister::recursiveAddFiles(std::vector<std::string> &filenames, const st
         else if (recursive)
         {
             // Directory
-            FileLister::recursiveAddFiles(filenames, filename, recursive);
+            addFilesInDirectory(filenames, filename, recursive, exclude);
         }
     }
     globfree(&glob_results);
@@ -211,8 +349,11 @@ static HANDLE MyFindFirstFile(std::string path, LPWIN32_FIND_DATA findData)
 
 #endif // defined(UNICODE)
 
-void FileLister::recursiveAddFiles(std::vector<std::string> &filenames, const std::string &path, bool recursive)
+void FileLister::recursiveAddFiles(std::vector<std::string> &filenames, const std::string &path, bool recursive, const std::list<std::string> &exclude)
 {
+    if (FileLister::excluded(path, exclude))
+        return;
+
     // oss is the search string passed into FindFirst and FindNext.
     // bdir is the base directory which is used to form pathnames.
     // It always has a trailing backslash available for concatenation.
@@ -270,6 +411,15 @@ void FileLister::recursiveAddFiles(std::vector<std::string> &filenames, const st
         std::ostringstream fname;
         fname << bdir.str().c_str() << ansiFfd;
 
+        // Skip the excluded files and directories before reading them
+        if (FileLister::excluded(fname.str(), exclude))
+        {
+#if defined(UNICODE)
+            delete [] ansiFfd;
+#endif // defined(UNICODE)
+            continue;
+        }
+
         if ((ffd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
         {
             // File
@@ -281,7 +431,7 @@ void FileLister::recursiveAddFiles(std::vector<std::string> &filenames, const st
         else if (recursive)
         {
             // Directory
-            FileLister::recursiveAddFiles(filenames, fname.str().c_str(), recursive);
+            FileLister::recursiveAddFiles(filenames, fname.str().c_str(), recursive, exclude);
         }
 #if defined(UNICODE)
         delete [] ansiFfd;
@@ -19,6 +19,7 @@
 #ifndef FileListerH
 #define FileListerH
 
+#include <list>
 #include <vector>
 #include <string>
 
@@ -42,7 +43,31 @@
 class FileLister
 {
 public:
-    static void recursiveAddFiles(std::vector<std::string> &filenames, const std::string &path, bool recursive);
+    /**
+     * Add the source files in a path to a list.
+     * @param filenames the files are added here
+     * @param path a file, a directory or a pattern
+     * @param recursive if true, the source files in the directories are
+     * added recursively. If false, the directories are skipped and every
+     * file is added, not only the source files.
+     * @param exclude paths and patterns of the files and directories that
+     * are skipped, see excluded(). The excluded directories are not read.
+     */
+    static void recursiveAddFiles(std::vector<std::string> &filenames, const std::string &path, bool recursive, const std::list<std::string> &exclude = std::list<std::string>());
+
+    /**
+     * Is a file or directory excluded? A path or pattern excludes the
+     * file if it matches the name of the file, or the path of the file
+     * or of a parent directory. The patterns can contain the wildcards
+     * '*' and '?'. E.g. "src/gen", "build", "third_*" and
+     * "*_generated.cpp".
+     * @param path the file or directory
+     * @param exclude the paths and patterns, without "./" at the start
+     * or "/" at the end
+     * @return true if the file or directory is excluded
+     */
+    static bool excluded(const std::string &path, const std::list<std::string> &exclude);
+
     static std::string simplifyPath(const char *originalPath);
     static bool sameFileName(const char fname1[], const char fname2[]);
     static bool acceptFile(const std::string &filename);
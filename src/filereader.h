@@ -0,0 +1,55 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2009 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/
+ */
+
+//---------------------------------------------------------------------------
+#ifndef filereaderH
+#define filereaderH
+//---------------------------------------------------------------------------
+
+#include <string>
+
+/// @addtogroup Core
+/// @{
+
+/**
+ * @brief This is an interface for reading the files that are checked and
+ * the files that they include. Implement it to check code that is not in
+ * the file system, e.g. the unsaved files of an editor, see
+ * CppCheck::fileReader().
+ */
+class FileReader
+{
+public:
+    virtual ~FileReader() { }
+
+    /**
+     * Read a file.
+     * @param filename the name of the file, e.g. "src/main.cpp" or
+     * "include/main.h"
+     * @param code the content of the file is written here
+     * @return false if there is no such file. Then the included file is
+     * searched from the next include path.
+     */
+    virtual bool read(const std::string &filename, std::string &code) = 0;
+};
+
+/// @}
+
+//---------------------------------------------------------------------------
+#endif
+
@@ -33,11 +33,11 @@ long MathLib::toLongNumber(const std::string &str)
 {
     if (strncmp(str.c_str(), "0x", 2) == 0)
     {
-        return strtoul(str.c_str(), '\0', 16);
+        return strtoul(str.c_str(), NULL, 16);
     }
     if (strncmp(str.c_str(), "0", 1) == 0)
     {
-        return strtoul(str.c_str(), '\0', 8);
+        return strtoul(str.c_str(), NULL, 8);
     }
     return atol(str.c_str());
 }
@@ -57,12 +57,7 @@ std::string MathLib::toString(T d)
 
 bool MathLib::isInt(const std::string & str)
 {
-    if (str.find(".", 0) != std::string::npos || str.find("e", 0) != std::string::npos
-        || str.find("E", 0) != std::string::npos)
-    {
-        return false;
-    }
-    return true;
+    return (str.find_first_of(".eE") == std::string::npos);
 }
 
 std::string MathLib::add(const std::string & first, const std::string & second)
@@ -135,6 +130,27 @@ std::string MathLib::calculate(const std::string &first, const std::string &seco
     return result;
 }
 
+long MathLib::calculate(long first, long second, char action)
+{
+    switch (action)
+    {
+    case '+':
+        return first + second;
+
+    case '-':
+        return first - second;
+
+    case '*':
+        return first * second;
+
+    case '/':
+        return first / second;
+
+    default:
+        return 0;
+    }
+}
+
 std::string MathLib::sin(const std::string &tok)
 {
     return toString<double>(::sin(toDoubleNumber(tok)));
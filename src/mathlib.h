@@ -43,6 +43,12 @@ public:
     static std::string divide(const std::string & first, const std::string & second);
     static std::string calculate(const std::string & first, const std::string & second, char action);
 
+    /**
+     * Calculate with integers, see calculate() for the strings
+     * @return the result, 0 if the action is not one of + - * and /
+     */
+    static long calculate(long first, long second, char action);
+
     static std::string sin(const std::string & tok);
     static std::string cos(const std::string & tok);
     static std::string tan(const std::string & tok);
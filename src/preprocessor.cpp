@@ -21,6 +21,8 @@
 #include "tokenize.h"
 #include "token.h"
 #include "filelister.h"
+#include "filecache.h"
+#include "filereader.h"
 
 #include <algorithm>
 #include <stdexcept>
@@ -30,14 +32,37 @@
 #include <cstdlib>
 #include <cctype>
 #include <cstring>
+#include <cstdio>
 #include <vector>
 #include <set>
 
-Preprocessor::Preprocessor(const Settings *settings, ErrorLogger *errorLogger) : _settings(settings), _errorLogger(errorLogger)
+Preprocessor::Preprocessor(const Settings *settings, ErrorLogger *errorLogger, FileCache *fileCache, FileReader *fileReader)
+        : _settings(settings), _errorLogger(errorLogger), _fileCache(fileCache), _fileReader(fileReader)
 {
 
 }
 
+bool Preprocessor::readInclude(const std::string &filename, std::string &code)
+{
+    if (_fileReader)
+    {
+        std::string content;
+        if (!_fileReader->read(filename, content))
+            return false;
+        code = read(content);
+        return true;
+    }
+
+    if (_fileCache)
+        return _fileCache->read(filename, code);
+
+    std::ifstream fin(filename.c_str());
+    if (!fin.is_open())
+        return false;
+    code = read(fin);
+    return true;
+}
+
 void Preprocessor::writeError(const std::string &fileName, const std::string &code, size_t endPos, ErrorLogger *errorLogger, const std::string &errorType, const std::string &errorText)
 {
     if (!errorLogger)
@@ -226,7 +251,50 @@ void Preprocessor::writeError(const std::string &fileName, const std::string &co
                                   errorType));
 }
 
-static char readChar(std::istream &istr)
+namespace
+{
+/** Read a string like a stream, without copying it */
+class StringReader
+{
+public:
+    StringReader(const std::string &str) : _str(str), _pos(0), _good(true)
+    { }
+
+    int get()
+    {
+        if (_pos >= _str.size())
+        {
+            _good = false;
+            return EOF;
+        }
+        return static_cast<unsigned char>(_str[_pos++]);
+    }
+
+    /** Like std::istream::peek(), the reader is not good at the end */
+    int peek()
+    {
+        if (_pos >= _str.size())
+        {
+            _good = false;
+            return EOF;
+        }
+        return static_cast<unsigned char>(_str[_pos]);
+    }
+
+    bool good() const
+    {
+        return _good;
+    }
+
+private:
+    const std::string &_str;
+    std::string::size_type _pos;
+    bool _good;
+};
+}
+
+template <class T>
+static char readChar(T &istr)
 {
     char ch = (char)istr.get();
 
@@ -242,7 +310,8 @@ static char readChar(std::istream &istr)
 }
 
 /** Just read the code into a string. Perform simple cleanup of the code */
-std::string Preprocessor::read(std::istream &istr)
+template <class T>
+std::string Preprocessor::readCode(T &istr)
 {
     // Get filedata from stream..
     bool ignoreSpace = true;
@@ -327,6 +396,17 @@ std::string Preprocessor::read(std::istream &istr)
     return removeComments(code.str());
 }
 
+std::string Preprocessor::read(std::istream &istr)
+{
+    return readCode(istr);
+}
+
+std::string Preprocessor::read(const std::string &code)
+{
+    StringReader reader(code);
+    return readCode(reader);
+}
+
 
 
 std::string Preprocessor::removeComments(const std::string &str)
@@ -440,7 +520,7 @@ void Preprocessor::preprocess(std::istream &istr, std::map<std::string, std::str
     std::string data;
     preprocess(istr, data, configs, filename, includePaths);
     for (std::list<std::string>::const_iterator it = configs.begin(); it != configs.end(); ++it)
-        result[ *it ] = Preprocessor::getcode(data, *it, filename, _errorLogger);
+        result[ *it ] = Preprocessor::getcode(data, *it, filename, _errorLogger, _settings);
 }
 
 std::string Preprocessor::removeSpaceNearNL(const std::string &str)
@@ -506,9 +586,35 @@ std::string Preprocessor::replaceIfDefined(const std::string &str)
 }
 
 void Preprocessor::preprocess(std::istream &istr, std::string &processedFile, std::list<std::string> &resultConfigurations, const std::string &filename, const std::list<std::string> &includePaths)
+{
+    preprocess(istr, processedFile, filename, includePaths);
+
+    // Get all possible configurations..
+    resultConfigurations = getcfgs(processedFile);
+}
+
+void Preprocessor::preprocess(const std::string &code, std::string &processedFile, std::list<std::string> &resultConfigurations, const std::string &filename, const std::list<std::string> &includePaths)
+{
+    preprocess(code, processedFile, filename, includePaths);
+
+    // Get all possible configurations..
+    resultConfigurations = getcfgs(processedFile);
+}
+
+void Preprocessor::preprocess(std::istream &istr, std::string &processedFile, const std::string &filename, const std::list<std::string> &includePaths)
 {
     processedFile = read(istr);
+    simplifyCode(processedFile, filename, includePaths);
+}
 
+void Preprocessor::preprocess(const std::string &code, std::string &processedFile, const std::string &filename, const std::list<std::string> &includePaths)
+{
+    processedFile = read(code);
+    simplifyCode(processedFile, filename, includePaths);
+}
+
+void Preprocessor::simplifyCode(std::string &processedFile, const std::string &filename, const std::list<std::string> &includePaths)
+{
     // Replace all tabs with spaces..
     std::replace(processedFile.begin(), processedFile.end(), '\t', ' ');
 
@@ -547,9 +653,6 @@ void Preprocessor::preprocess(std::istream &istr, std::string &processedFile, st
     handleIncludes(processedFile, filename, includePaths);
 
     processedFile = replaceIfDefined(processedFile);
-
-    // Get all possible configurations..
-    resultConfigurations = getcfgs(processedFile);
 }
 
 
@@ -858,7 +961,7 @@ bool Preprocessor::match_cfg_def(const std::map<std::string, std::string> &cfg,
 }
 
 
-std::string Preprocessor::getcode(const std::string &filedata, std::string cfg, const std::string &filename, ErrorLogger *errorLogger)
+std::string Preprocessor::getcode(const std::string &filedata, std::string cfg, const std::string &filename, ErrorLogger *errorLogger, const Settings *settings)
 {
     std::ostringstream ret;
 
@@ -904,6 +1007,9 @@ std::string Preprocessor::getcode(const std::string &filedata, std::string cfg,
     std::string line;
     while (getline(istr, line))
     {
+        if (settings && settings->terminated())
+            return "";
+
         std::string def = getdef(line, true);
         std::string ndef = getdef(line, false);
 
@@ -1078,12 +1184,9 @@ void Preprocessor::handleIncludes(std::string &code, const std::string &filename
         std::string processedFile;
         for (std::list<std::string>::const_iterator iter = includePaths.begin(); iter != includePaths.end(); ++iter)
         {
-            std::ifstream fin;
-            fin.open((*iter + filename).c_str());
-            if (fin.is_open())
+            if (readInclude(*iter + filename, processedFile))
             {
                 filename = *iter + filename;
-                processedFile = Preprocessor::read(fin);
                 break;
             }
         }
@@ -1091,9 +1194,7 @@ void Preprocessor::handleIncludes(std::string &code, const std::string &filename
         if (headerType == 1 && processedFile.length() == 0)
         {
             filename = paths.back() + filename;
-            std::ifstream fin(filename.c_str());
-            if (fin.is_open())
-                processedFile = Preprocessor::read(fin);
+            readInclude(filename, processedFile);
         }
 
         if (processedFile.length() > 0)
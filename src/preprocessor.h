@@ -28,6 +28,9 @@
 #include "errorlogger.h"
 #include "settings.h"
 
+class FileCache;
+class FileReader;
+
 /// @addtogroup Core
 /// @{
 
@@ -35,7 +38,15 @@
 class Preprocessor
 {
 public:
-    Preprocessor(const Settings *settings = 0, ErrorLogger *errorLogger = 0);
+    /**
+     * @param settings the settings
+     * @param errorLogger the errors are reported here
+     * @param fileCache if given, the included files are read through this
+     * cache
+     * @param fileReader if given, the included files are read through this
+     * instead of the file system
+     */
+    Preprocessor(const Settings *settings = 0, ErrorLogger *errorLogger = 0, FileCache *fileCache = 0, FileReader *fileReader = 0);
 
     /**
      * Extract the code for each configuration
@@ -69,13 +80,40 @@ public:
      */
     void preprocess(std::istream &istr, std::string &processedFile, std::list<std::string> &resultConfigurations, const std::string &filename, const std::list<std::string> &includePaths);
 
+    /**
+     * Read the code and the included files without extracting the
+     * configurations. Use this with getcode() when the configuration
+     * that is checked is known.
+     *
+     * @param istr The (file/string) stream to read from.
+     * @param processedFile Give reference to empty string as a parameter,
+     * function will fill processed file here.
+     * @param filename The name of the file to check e.g. "src/main.cpp"
+     * @param includePaths List of paths where incude files should be searched from.
+     */
+    void preprocess(std::istream &istr, std::string &processedFile, const std::string &filename, const std::list<std::string> &includePaths);
+
+    /**
+     * Same as the preprocess() above, but the code is given as a string
+     * and it is not copied into a stream.
+     */
+    void preprocess(const std::string &code, std::string &processedFile, std::list<std::string> &resultConfigurations, const std::string &filename, const std::list<std::string> &includePaths);
+
+    /** Read the code and the included files, the code is given as a string */
+    void preprocess(const std::string &code, std::string &processedFile, const std::string &filename, const std::list<std::string> &includePaths);
+
     /** Just read the code into a string. Perform simple cleanup of the code */
     static std::string read(std::istream &istr);
 
+    /** Same as read(std::istream &), but the code is given as a string */
+    static std::string read(const std::string &code);
+
     /**
      * Get preprocessed code for a given configuration
+     * @param settings if the checking is terminated, see Settings::terminate(),
+     * the reading stops and an empty string is returned
      */
-    static std::string getcode(const std::string &filedata, std::string cfg, const std::string &filename, ErrorLogger *errorLogger);
+    static std::string getcode(const std::string &filedata, std::string cfg, const std::string &filename, ErrorLogger *errorLogger, const Settings *settings = 0);
 
 protected:
 
@@ -148,8 +186,28 @@ private:
      */
     void handleIncludes(std::string &code, const std::string &filename, const std::list<std::string> &includePaths);
 
+    /**
+     * Read an included file
+     * @param filename the file
+     * @param code the code is written here, see read()
+     * @return false if the file can't be read
+     */
+    bool readInclude(const std::string &filename, std::string &code);
+
+    /** Read the code from a stream or a StringReader, see read() */
+    template <class T>
+    static std::string readCode(T &istr);
+
+    /**
+     * Simplify the code that read() gives and read the included files,
+     * see preprocess()
+     */
+    void simplifyCode(std::string &processedFile, const std::string &filename, const std::list<std::string> &includePaths);
+
     const Settings *_settings;
     ErrorLogger *_errorLogger;
+    FileCache *_fileCache;
+    FileReader *_fileReader;
 };
 
 /// @}
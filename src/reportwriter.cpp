@@ -0,0 +1,77 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2009 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#include "reportwriter.h"
+
+//---------------------------------------------------------------------------
+
+ReportWriter::ReportWriter(std::ostream &ostr, bool xml, std::string::size_type bufferSize)
+        : _ostr(ostr), _xml(xml), _bufferSize(bufferSize)
+{
+    // Reserve a little extra so a message that doesn't fit doesn't
+    // make the buffer grow
+    _buffer.reserve(_bufferSize + 1024);
+}
+
+ReportWriter::~ReportWriter()
+{
+    flush();
+}
+
+void ReportWriter::writeHeader()
+{
+    if (_xml)
+    {
+        _buffer += ErrorLogger::ErrorMessage::getXMLHeader();
+        _buffer += "\n";
+    }
+}
+
+void ReportWriter::writeFooter()
+{
+    if (_xml)
+    {
+        _buffer += ErrorLogger::ErrorMessage::getXMLFooter();
+        _buffer += "\n";
+    }
+}
+
+void ReportWriter::write(const ErrorLogger::ErrorMessage &msg)
+{
+    if (_xml)
+        msg.toXML(_buffer);
+    else
+        msg.toText(_buffer);
+    _buffer += "\n";
+
+    if (_buffer.size() >= _bufferSize)
+        flush();
+}
+
+void ReportWriter::flush()
+{
+    if (_buffer.empty())
+        return;
+
+    _ostr.write(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
+    _ostr.flush();
+
+    // clear() keeps the reserved memory
+    _buffer.clear();
+}
+
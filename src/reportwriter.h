@@ -0,0 +1,78 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2009 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/
+ */
+
+//---------------------------------------------------------------------------
+#ifndef reportwriterH
+#define reportwriterH
+//---------------------------------------------------------------------------
+
+#include <ostream>
+#include <string>
+#include "errorlogger.h"
+
+/// @addtogroup Core
+/// @{
+
+/**
+ * @brief Write the error messages to a stream as they are found.
+ *
+ * The messages are formatted straight into a buffer of fixed size and
+ * the buffer is written to the stream when it is full. The memory usage
+ * doesn't depend on the number of messages and large reports are written
+ * in big blocks instead of one write per message.
+ */
+class ReportWriter
+{
+public:
+    /**
+     * @param ostr the stream where the report is written
+     * @param xml true => xml format, false => text format
+     * @param bufferSize the buffer is written when it has this many characters
+     */
+    ReportWriter(std::ostream &ostr, bool xml, std::string::size_type bufferSize = 0x10000);
+
+    /** Writes what is left in the buffer */
+    ~ReportWriter();
+
+    /** Write the xml header. Nothing is written in text format. */
+    void writeHeader();
+
+    /** Write the xml footer. Nothing is written in text format. */
+    void writeFooter();
+
+    /** Write an error message */
+    void write(const ErrorLogger::ErrorMessage &msg);
+
+    /** Write the buffered messages to the stream */
+    void flush();
+
+private:
+    std::ostream &_ostr;
+    const bool _xml;
+    const std::string::size_type _bufferSize;
+    std::string _buffer;
+
+    /** Not copyable */
+    ReportWriter(const ReportWriter &);
+    ReportWriter &operator=(const ReportWriter &);
+};
+
+/// @}
+//---------------------------------------------------------------------------
+#endif
+
@@ -18,7 +18,6 @@
 
 #include "settings.h"
 
-#include <algorithm>
 
 Settings::Settings()
 {
@@ -31,7 +30,10 @@ Settings::Settings()
     _xml = false;
     _unusedFunctions = false;
     _jobs = 1;
+    _checkThreads = 1;
     _exitCode = 0;
+    _terminate = 0;
+    _progress = false;
 #ifdef __GNUC__
     _showtime = false;
 #endif
@@ -53,17 +55,35 @@ void Settings::autoDealloc(std::istream &istr)
             continue;
 
         // Add classname to list
-        _autoDealloc.push_back(line);
+        _autoDealloc.insert(line);
     }
 }
 
 void Settings::addAutoAllocClass(const std::string &name)
 {
-    _autoDealloc.push_back(name);
+    _autoDealloc.insert(name);
 }
 
-bool Settings::isAutoDealloc(const char classname[]) const
+bool Settings::isAutoDealloc(const std::string &classname) const
 {
-    return (std::find(_autoDealloc.begin(), _autoDealloc.end(), classname) != _autoDealloc.end());
+    return (_autoDealloc.find(classname) != _autoDealloc.end());
+}
+
+void Settings::terminate()
+{
+#ifdef __GNUC__
+    __sync_lock_test_and_set(&_terminate, 1);
+#else
+    _terminate = 1;
+#endif
+}
+
+bool Settings::terminated() const
+{
+#ifdef __GNUC__
+    return (__sync_val_compare_and_swap(&_terminate, 0, 0) != 0);
+#else
+    return (_terminate != 0);
+#endif
 }
 
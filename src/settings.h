@@ -20,6 +20,8 @@
 #define SETTINGS_H
 
 #include <list>
+#include <map>
+#include <set>
 #include <string>
 #include <istream>
 
@@ -36,7 +38,13 @@ class Settings
 {
 private:
     /** classes that are automaticly deallocated */
-    std::list<std::string> _autoDealloc;
+    std::set<std::string> _autoDealloc;
+
+    /**
+     * Has the checking been stopped, see terminate(). It is set and read
+     * in different threads, and it is read in const functions.
+     */
+    mutable volatile int _terminate;
 
 public:
     Settings();
@@ -61,6 +69,10 @@ public:
         time. Default is 1. */
     unsigned int _jobs;
 
+    /** How many threads should run the checks of one file at the same
+        time. Default is 1. */
+    unsigned int _checkThreads;
+
     /** If errors are found, this value is returned from main().
         Default value is 0. */
     int _exitCode;
@@ -70,10 +82,57 @@ public:
     bool _showtime;
 #endif
 
+    /** Show the phase of the checking of each file, see ErrorLogger::reportProgress() */
+    bool _progress;
+
     /** List of include paths, e.g. "my/includes/" which should be used
         for finding include files inside source files. */
     std::list<std::string> _includePaths;
 
+    /** Paths and patterns of the files and directories that are not
+        checked, e.g. "third_party" or "*_generated.cpp". See
+        FileLister::excluded(). */
+    std::list<std::string> _exclude;
+
+    /** The preprocessor configuration and include paths of a file in
+        a compilation database, see _fileSettings. */
+    class FileSettings
+    {
+    public:
+        /** The defines, e.g. "DEBUG;VERSION=2". Only this configuration
+            of the file is checked. */
+        std::string _cfg;
+
+        /** The include paths, e.g. "/project/include/". These are used
+            before _includePaths. */
+        std::list<std::string> _includePaths;
+    };
+
+    /** The files in a compilation database and the preprocessor settings
+        they are compiled with. The key is the file name. */
+    std::map<std::string, FileSettings> _fileSettings;
+
+    /** Path of the socket where the daemon listens to requests, see
+        Daemon. Empty => no daemon. */
+    std::string _daemon;
+
+    /** Directory where the function summaries are written, e.g.
+        "summaries/". Empty => no summaries are used. */
+    std::string _summaryDir;
+
+    /** Functions in other files that return allocated memory. The value
+        is a CheckMemoryLeak::AllocType. */
+    std::map<std::string, int> _allocFunctions;
+
+    /** Functions in other files that deallocate a parameter. The key is
+        the function name and the parameter number, the value is a
+        CheckMemoryLeak::AllocType. */
+    std::map<std::pair<std::string, unsigned int>, int> _deallocFunctions;
+
+    /** The first lines of the summary files that have been read. The
+        results of a file depend on them, see FileCache. */
+    std::string _summaryHeaders;
+
     /** Fill list of automaticly deallocated classes */
     void autoDealloc(std::istream &istr);
 
@@ -81,7 +140,17 @@ public:
     void addAutoAllocClass(const std::string &name);
 
     /** is a class automaticly deallocated? */
-    bool isAutoDealloc(const char classname[]) const;
+    bool isAutoDealloc(const std::string &classname) const;
+
+    /**
+     * Stop the checking. This can be called in another thread while a
+     * file is checked. The checking polls terminated() between its
+     * phases and stops as soon as it can.
+     */
+    void terminate();
+
+    /** Has terminate() been called? */
+    bool terminated() const;
 };
 
 /// @}
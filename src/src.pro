@@ -31,7 +31,14 @@ HEADERS += check.h \
            settings.h \
            threadexecutor.h \
            token.h \
-           tokenize.h
+           tokenize.h \
+           tokenmatcher.h \
+           errorqueue.h \
+           reportwriter.h \
+           compiledatabase.h \
+           filecache.h \
+           daemon.h \
+           filereader.h
 SOURCES += checkautovariables.cpp \
            checkbufferoverrun.cpp \
            checkclass.cpp \
@@ -51,7 +58,15 @@ SOURCES += checkautovariables.cpp \
            settings.cpp \
            threadexecutor.cpp \
            token.cpp \
-           tokenize.cpp
+           tokenize.cpp \
+           tokenmatcher.cpp \
+           errorqueue.cpp \
+           reportwriter.cpp \
+           compiledatabase.cpp \
+           filecache.cpp \
+           daemon.cpp
+
+unix:LIBS += -lpthread
 
 win32 {
     CONFIG += embed_manifest_exe console
@@ -22,6 +22,7 @@
 #include <algorithm>
 #if defined(__GNUC__) && !defined(__MINGW32__)
 #include <sys/wait.h>
+#include <sys/select.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <cstdlib>
@@ -54,7 +55,7 @@ bool ThreadExecutor::handleRead(unsigned int &result)
         return false;
     }
 
-    if (type != '1' && type != '2' && type != '3')
+    if (type != '1' && type != '2' && type != '3' && type != '4' && type != '5')
     {
         std::cerr << "#### You found a bug from cppcheck.\nThreadExecutor::handleRead error, type was:" << type << std::endl;
         exit(0);
@@ -100,6 +101,22 @@ bool ThreadExecutor::handleRead(unsigned int &result)
         result += fileResult;
         _errorLogger.reportStatus(_fileCount, _filenames.size());
     }
+    else if (type == '4')
+    {
+        std::istringstream iss(buf);
+        _checkUnusedFunctions.readSummary(iss);
+    }
+    else if (type == '5')
+    {
+        std::istringstream iss(buf);
+        unsigned int cfg = 0, cfgCount = 0, value = 0;
+        iss >> cfg >> cfgCount >> value;
+        std::string filename, stage;
+        iss.ignore();
+        std::getline(iss, filename);
+        std::getline(iss, stage);
+        _errorLogger.reportProgress(filename, stage, cfg, cfgCount, value);
+    }
 
     delete [] buf;
     return true;
@@ -128,22 +145,67 @@ unsigned int ThreadExecutor::check()
         exit(1);
     }
 
+    // The settings that the child processes use
+    Settings settings(_settings);
+
     unsigned int childCount = 0;
-    for (unsigned int i = 0; i < _filenames.size(); i++)
+    if (!_settings._summaryDir.empty())
     {
-        // Keep only wanted amount of child processes running at a time.
-        if (childCount >= _settings._jobs)
+        // Write the summaries of the files in child processes..
+        for (unsigned int i = 0; i < _filenames.size(); i++)
         {
-            while (handleRead(result))
+            if (childCount >= _settings._jobs)
             {
+                int stat = 0;
+                waitpid(0, &stat, 0);
+                --childCount;
+            }
 
+            pid_t pid = fork();
+            if (pid < 0)
+            {
+                // Error
+                std::cerr << "Failed to create child process" << std::endl;
+                exit(EXIT_FAILURE);
             }
+            else if (pid == 0)
+            {
+                CppCheck fileChecker(*this);
+                fileChecker.settings(_settings);
+                fileChecker.createSummary(_filenames[i]);
+                exit(0);
+            }
+
+            ++childCount;
+        }
 
+        while (childCount > 0)
+        {
             int stat = 0;
             waitpid(0, &stat, 0);
             --childCount;
         }
 
+        // ..and read them all before any file is checked. The child
+        // processes don't need to write the summaries again.
+        CppCheck summaries(*this);
+        summaries.settings(_settings);
+        for (unsigned int i = 0; i < _filenames.size(); i++)
+            summaries.addFile(_filenames[i]);
+        summaries.loadSummaries();
+        settings = summaries.settings();
+        settings._summaryDir = "";
+    }
+
+    for (unsigned int i = 0; i < _filenames.size(); i++)
+    {
+        // Keep only wanted amount of child processes running at a time.
+        if (childCount >= _settings._jobs)
+        {
+            waitForChild(result);
+            --childCount;
+        }
+
         pid_t pid = fork();
         if (pid < 0)
         {
@@ -154,9 +216,21 @@ unsigned int ThreadExecutor::check()
         else if (pid == 0)
         {
             CppCheck fileChecker(*this);
-            fileChecker.settings(_settings);
+            fileChecker.settings(settings);
             fileChecker.addFile(_filenames[i]);
+            fileChecker.collectUnusedFunctions();
             unsigned int result = fileChecker.check();
+            if (settings._unusedFunctions)
+            {
+                // Write the summary line by line so that the messages
+                // are small enough to be written atomically
+                std::ostringstream summary;
+                fileChecker.writeUnusedFunctions(summary);
+                std::istringstream istr(summary.str());
+                std::string line;
+                while (std::getline(istr, line))
+                    writeToPipe('4', line + "\n");
+            }
             std::ostringstream oss;
             oss << result;
             writeToPipe('3', oss.str());
@@ -168,8 +242,7 @@ unsigned int ThreadExecutor::check()
 
     while (childCount > 0)
     {
-        int stat = 0;
-        waitpid(0, &stat, 0);
+        waitForChild(result);
         --childCount;
     }
 
@@ -178,9 +251,38 @@ unsigned int ThreadExecutor::check()
 
     }
 
+    // Check the usage of global functions in all the files..
+    if (_settings._unusedFunctions)
+    {
+        if (_settings._errorsOnly == false)
+            _errorLogger.reportOut("Checking usage of global functions..");
+
+        _checkUnusedFunctions.setErrorLogger(&_errorLogger);
+        result += _checkUnusedFunctions.check();
+    }
+
     return result;
 }
 
+void ThreadExecutor::waitForChild(unsigned int &result)
+{
+    int stat = 0;
+    while (waitpid(0, &stat, WNOHANG) == 0)
+    {
+        // Read the pipe meanwhile so the child doesn't block when it's full
+        if (!handleRead(result))
+        {
+            fd_set rfds;
+            FD_ZERO(&rfds);
+            FD_SET(_pipe[0], &rfds);
+            struct timeval tv;
+            tv.tv_sec = 0;
+            tv.tv_usec = 10000;
+            select(_pipe[0] + 1, &rfds, NULL, NULL, &tv);
+        }
+    }
+}
+
 void ThreadExecutor::writeToPipe(char type, const std::string &data)
 {
     unsigned int len = data.length() + 1;
@@ -214,6 +316,17 @@ void ThreadExecutor::reportStatus(unsigned int /*index*/, unsigned int /*max*/)
     // Not used
 }
 
+void ThreadExecutor::reportProgress(const std::string &filename, const std::string &stage, unsigned int cfg, unsigned int cfgCount, unsigned int value)
+{
+    // The progress is only written to the pipe when it is shown
+    if (!_settings._progress)
+        return;
+
+    std::ostringstream oss;
+    oss << cfg << " " << cfgCount << " " << value << "\n" << filename << "\n" << stage;
+    writeToPipe('5', oss.str());
+}
+
 #else
 unsigned int ThreadExecutor::check()
 {
@@ -232,5 +345,10 @@ void ThreadExecutor::reportErr(const ErrorLogger::ErrorMessage &/*msg*/)
 void ThreadExecutor::reportStatus(unsigned int /*index*/, unsigned int /*max*/)
 {
 
+}
+
+void ThreadExecutor::reportProgress(const std::string &/*filename*/, const std::string &/*stage*/, unsigned int /*cfg*/, unsigned int /*cfgCount*/, unsigned int /*value*/)
+{
+
 }
 #endif
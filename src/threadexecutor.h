@@ -24,6 +24,7 @@
 #include <list>
 #include "settings.h"
 #include "errorlogger.h"
+#include "checkunusedfunctions.h"
 
 /**
  * This class will take a list of filenames and settings and check then
@@ -38,6 +39,7 @@ public:
     virtual void reportOut(const std::string &outmsg);
     virtual void reportErr(const ErrorLogger::ErrorMessage &msg);
     virtual void reportStatus(unsigned int index, unsigned int max);
+    virtual void reportProgress(const std::string &filename, const std::string &stage, unsigned int cfg, unsigned int cfgCount, unsigned int value);
 
 private:
     const std::vector<std::string> &_filenames;
@@ -45,9 +47,18 @@ private:
     ErrorLogger &_errorLogger;
     unsigned int _fileCount;
 
+    /** The usage of global functions in all the files, merged from the child processes */
+    CheckUnusedFunctions _checkUnusedFunctions;
+
 #if defined(__GNUC__) && !defined(__MINGW32__)
 private:
     bool handleRead(unsigned int &result);
+
+    /**
+     * Wait until a child process exits and read its messages meanwhile
+     * @param result the results of the files are added here
+     */
+    void waitForChild(unsigned int &result);
     void writeToPipe(char type, const std::string &data);
     int _pipe[2];
     std::list<std::string> _errorList;
@@ -46,6 +46,10 @@ Token::~Token()
 
 void Token::str(const std::string &s)
 {
+    // A token that is not the same bracket anymore can't keep its link
+    if (_link && s != _str)
+        unlink();
+
     _str = s;
     _isName = bool(_str[0] == '_' || std::isalpha(_str[0]));
     _isNumber = bool(std::isdigit(_str[(_str[0] == '-') ? 1 : 0]) != 0);
@@ -72,6 +76,7 @@ void Token::deleteNext()
 {
     Token *n = _next;
     _next = n->next();
+    n->unlink();
     delete n;
     if (_next)
         _next->previous(this);
@@ -81,6 +86,9 @@ void Token::deleteThis()
 {
     if (_next)
     {
+        // This token takes over the content of the next token, including
+        // its link. The old partner of this token is left unlinked.
+        unlink();
         _str = _next->_str;
         _isName = _next->_isName;
         _isNumber = _next->_isNumber;
@@ -89,6 +97,9 @@ void Token::deleteThis()
         _fileIndex = _next->_fileIndex;
         _linenr = _next->_linenr;
         _link = _next->_link;
+        if (_link)
+            _link->_link = this;
+        _next->_link = 0;
         deleteNext();
     }
     else if (_previous)
@@ -125,6 +136,7 @@ void Token::replace(Token *replaceThis, Token *start, Token *end)
     end->next(replaceThis->next());
 
     // Delete old token, which is replaced
+    replaceThis->unlink();
     delete replaceThis;
 }
 
@@ -539,6 +551,13 @@ Token *Token::link() const
     return _link;
 }
 
+void Token::unlink()
+{
+    if (_link && _link->_link == this)
+        _link->_link = 0;
+    _link = 0;
+}
+
 void Token::printOut(const char *title) const
 {
     std::cout << stringifyList(true, title) << std::endl;
@@ -208,11 +208,28 @@ public:
      * Return token where this token links to.
      * Supported links are:
      * "{" <-> "}"
+     * "(" <-> ")"
+     * "[" <-> "]"
+     *
+     * The links are created by the Tokenizer right after the tokens are
+     * created, so they can be used by all checks to jump over a block
+     * instead of counting the indentation level.
+     *
+     * While the token list is simplified, a link is either correct or
+     * missing: the brackets that are added have no link, and a token that
+     * is deleted or changed loses its link. All the brackets are linked
+     * again at the end of Tokenizer::simplifyTokenList().
      *
      * @return The token where this token links to.
      */
     Token *link() const;
 
+    /**
+     * Remove the link of this token. If the linked token links back
+     * to this token, that link is removed too.
+     */
+    void unlink();
+
 private:
     void next(Token *next);
     void previous(Token *previous);
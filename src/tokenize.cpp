@@ -32,6 +32,8 @@
 #include <iostream>
 #include <sstream>
 #include <list>
+#include <map>
+#include <set>
 #include <algorithm>
 #include <cctype>
 
@@ -504,7 +506,10 @@ bool Tokenizer::tokenize(std::istream &code, const char FileName[])
         }
     }
 
-    return true;
+    // The token list has been modified above, link the brackets again so
+    // that Token::link() is valid for the checks on the unsimplified
+    // token list too.
+    return createLinks();
 }
 //---------------------------------------------------------------------------
 
@@ -570,6 +575,19 @@ void Tokenizer::simplifyTemplates()
     if (used.empty())
         return;
 
+    // The usages of the names that are followed by "<". The rewritten
+    // usages are removed lazily, and the usages in the expanded code are
+    // added when the code is expanded.
+    std::map<std::string, std::list<Token *> > usages;
+    for (Token *tok = _tokens; tok; tok = tok->next())
+    {
+        if (Token::Match(tok, "%var% <"))
+            usages[tok->str()].push_back(tok);
+    }
+
+    // The instantiations that have been expanded already
+    std::set<std::string> expanded;
+
     // expand templates
     for (std::list<Token *>::iterator iter1 = templates.begin(); iter1 != templates.end(); ++iter1)
     {
@@ -611,6 +629,44 @@ void Tokenizer::simplifyTemplates()
         }
         const std::string pattern(s + "> ");
 
+        // The code that is copied for each instantiation: the template
+        // itself and the member functions implemented outside the class
+        // definition. These are located once for all the instantiations.
+        std::vector<Token *> code;
+        int _indentlevel = 0;
+        for (Token *tok3 = _tokens; tok3; tok3 = tok3->next())
+        {
+            if (tok3->str() == "{")
+                ++_indentlevel;
+            else if (tok3->str() == "}")
+                --_indentlevel;
+
+            // Start of template / member function implemented outside
+            // class definition..
+            if (tok3 != tok && (_indentlevel != 0 || !Token::Match(tok3, (pattern + " :: %var% (").c_str())))
+                continue;
+
+            code.push_back(tok3);
+
+            // Skip the code that is copied
+            int indentlevel = 0;
+            for (; tok3; tok3 = tok3->next())
+            {
+                if (tok3->str() == "{")
+                    ++indentlevel;
+                else if (tok3->str() == "}")
+                {
+                    if (indentlevel <= 1)
+                        break;
+                    --indentlevel;
+                }
+            }
+            if (!tok3)
+                break;
+        }
+
+        std::list<Token *> &nameUsages = usages[name];
+
         for (std::list<Token *>::iterator iter2 = used.begin(); iter2 != used.end(); ++iter2)
         {
             Token *tok2 = *iter2;
@@ -635,14 +691,16 @@ void Tokenizer::simplifyTemplates()
             // New classname/funcname..
             const std::string name2(name + "<" + type2 + ">");
 
+            // Expand each instantiation only once
+            if (expanded.find(name2) != expanded.end())
+                continue;
+            expanded.insert(name2);
+
             // Copy template..
-            int _indentlevel = 0;
-            for (const Token *tok3 = _tokens; tok3; tok3 = tok3->next())
+            Token *last = _tokensBack;
+            for (std::vector<Token *>::const_iterator it = code.begin(); it != code.end(); ++it)
             {
-                if (tok3->str() == "{")
-                    ++_indentlevel;
-                else if (tok3->str() == "}")
-                    --_indentlevel;
+                const Token *tok3 = *it;
 
                 // Start of template..
                 if (tok3 == tok)
@@ -651,14 +709,14 @@ void Tokenizer::simplifyTemplates()
                 }
 
                 // member function implemented outside class definition
-                else if (_indentlevel == 0 && Token::Match(tok3, (pattern + " :: %var% (").c_str()))
+                else if (Token::Match(tok3, (pattern + " :: %var% (").c_str()))
                 {
                     addtoken(name2.c_str(), tok3->linenr(), tok3->fileIndex());
                     while (tok3->str() != "::")
                         tok3 = tok3->next();
                 }
 
-                // not part of template.. go on to next token
+                // the usage has been replaced already
                 else
                     continue;
 
@@ -692,8 +750,8 @@ void Tokenizer::simplifyTemplates()
                         if (itype < type.size())
                             addtoken(types2[itype].c_str(), tok3->linenr(), tok3->fileIndex());
 
-                        // replace name..
-                        else if (tok3->str() == name)
+                        // replace name, "name <" is replaced with the other usages below..
+                        else if (tok3->str() == name && !Token::simpleMatch(tok3->next(), "<"))
                             addtoken(name2.c_str(), tok3->linenr(), tok3->fileIndex());
 
                         // copy
@@ -703,6 +761,13 @@ void Tokenizer::simplifyTemplates()
                 }
             }
 
+            // Add the usages in the copied code..
+            for (Token *tok3 = last ? last->next() : _tokens; tok3; tok3 = tok3->next())
+            {
+                if (Token::Match(tok3, "%var% <"))
+                    usages[tok3->str()].push_back(tok3);
+            }
+
             // Replace all these template usages..
             s = name + " < " + type2 + " >";
             for (std::string::size_type pos = s.find(","); pos != std::string::npos; pos = s.find(",", pos + 2))
@@ -710,14 +775,25 @@ void Tokenizer::simplifyTemplates()
                 s.insert(pos + 1, " ");
                 s.insert(pos, " ");
             }
-            for (Token *tok4 = tok2; tok4; tok4 = tok4->next())
+            std::list<Token *>::iterator it = std::find(nameUsages.begin(), nameUsages.end(), tok2);
+            while (it != nameUsages.end())
             {
-                if (Token::simpleMatch(tok4, s.c_str()))
+                Token *tok4 = *it;
+                if (tok4->str() != name)
+                {
+                    it = nameUsages.erase(it);
+                }
+                else if (Token::simpleMatch(tok4, s.c_str()))
                 {
                     tok4->str(name2);
                     while (tok4->next()->str() != ">")
                         tok4->deleteNext();
                     tok4->deleteNext();
+                    it = nameUsages.erase(it);
+                }
+                else
+                {
+                    ++it;
                 }
             }
         }
@@ -1022,6 +1098,7 @@ bool Tokenizer::createLinks()
 {
     std::list<Token*> links;
     std::list<Token*> links2;
+    std::list<Token*> links3;
     for (Token *token = _tokens; token; token = token->next())
     {
         if (token->link())
@@ -1063,6 +1140,23 @@ bool Tokenizer::createLinks()
             links2.back()->link(token);
             links2.pop_back();
         }
+        else if (token->str() == "[")
+        {
+            links3.push_back(token);
+        }
+        else if (token->str() == "]")
+        {
+            if (links3.size() == 0)
+            {
+                // Error, [ and ] don't match.
+                syntaxError(token, '[');
+                return false;
+            }
+
+            token->link(links3.back());
+            links3.back()->link(token);
+            links3.pop_back();
+        }
     }
 
     if (links.size() > 0)
@@ -1079,13 +1173,19 @@ bool Tokenizer::createLinks()
         return false;
     }
 
+    if (links3.size() > 0)
+    {
+        // Error, [ and ] don't match.
+        syntaxError(_tokens, '[');
+        return false;
+    }
+
     return true;
 }
 
 void Tokenizer::simplifyTokenList()
 {
-    createLinks();
-
+    // The links were created by tokenize()
     simplifyNamespaces();
 
     // Combine wide strings
@@ -1480,6 +1580,10 @@ void Tokenizer::simplifyTokenList()
     // Simplify variable declarations
     simplifyVarDecl();
 
+    // The checking has been stopped => the token list is not checked
+    if (_settings && _settings->terminated())
+        return;
+
     // Replace NULL with 0..
     for (Token *tok = _tokens; tok; tok = tok->next())
     {
@@ -1520,6 +1624,9 @@ void Tokenizer::simplifyTokenList()
     bool modified = true;
     while (modified)
     {
+        if (_settings && _settings->terminated())
+            return;
+
         modified = false;
         modified |= simplifyConditions();
         modified |= simplifyFunctionReturn();
@@ -1563,6 +1670,10 @@ void Tokenizer::simplifyTokenList()
     }
 
     simplifyComma();
+
+    // Make sure the links are valid for the simplified checks
+    createLinks();
+
     if (_settings && _settings->_debug)
     {
         _tokens->printOut();
@@ -1575,6 +1686,10 @@ const Token *Tokenizer::findClosing(const Token *tok, const char *start, const c
     if (!tok)
         return 0;
 
+    // Use the precomputed link if there is one
+    if (tok->str() == start && tok->link() && tok->link()->str() == end)
+        return tok->link();
+
     // Find the closing "}"
     int indentLevel = 0;
     for (const Token *closing = tok->next(); closing; closing = closing->next())
@@ -2625,8 +2740,14 @@ bool Tokenizer::simplifyIfNot()
         {
             tok->deleteNext();
             tok->deleteNext();
-            tok->link()->insertToken("(");
-            tok->link()->str("!");
+            Token *par = tok->link();
+            par->insertToken("(");
+            par->str("!");
+
+            // The new "(" is linked to the ")"
+            par->unlink();
+            par->next()->link(tok);
+            tok->link(par->next());
             ret = true;
         }
     }
@@ -2970,10 +3091,29 @@ bool Tokenizer::simplifyCalculations()
             if (Token::simpleMatch(tok->next(), "/ 0"))
                 continue;
 
-            tok->str(MathLib::calculate(tok->str(), tok->tokAt(2)->str(), *(tok->strAt(1))));
+            if (MathLib::isInt(tok->str()) && MathLib::isInt(tok->strAt(2)))
+            {
+                // Calculate integers until the result is needed as a string
+                long result = MathLib::toLongNumber(tok->str());
+                do
+                {
+                    result = MathLib::calculate(result, MathLib::toLongNumber(tok->strAt(2)), *(tok->strAt(1)));
+                    tok->deleteNext();
+                    tok->deleteNext();
+                }
+                while (Token::Match(tok->next(), "[+-*/] %num% [],);=<>+-*]") &&
+                       MathLib::isInt(tok->strAt(2)) &&
+                       !Token::simpleMatch(tok->next(), "/ 0"));
 
-            tok->deleteNext();
-            tok->deleteNext();
+                tok->str(MathLib::toString<long>(result));
+            }
+            else
+            {
+                tok->str(MathLib::calculate(tok->str(), tok->tokAt(2)->str(), *(tok->strAt(1))));
+
+                tok->deleteNext();
+                tok->deleteNext();
+            }
 
             // evaluate "2 + 2 - 2 - 2"
             // as (((2 + 2) - 2) - 2) = 0
@@ -3183,7 +3323,7 @@ const Token * Tokenizer::findClassFunction(const Token *tok, const char classnam
 
     for (; tok; tok = tok->next())
     {
-        if (indentlevel == 0 && Token::Match(tok, classPattern.str().c_str()))
+        if (indentlevel == 0 && tok->str() == "class" && Token::Match(tok, classPattern.str().c_str()))
         {
             while (tok && tok->str() != "{")
                 tok = tok->next();
@@ -3240,7 +3380,7 @@ const Token * Tokenizer::findClassFunction(const Token *tok, const char classnam
             }
         }
 
-        else if (indentlevel == 0 && Token::Match(tok, externalPattern.str().c_str()))
+        else if (indentlevel == 0 && tok->str() == classname && Token::Match(tok, externalPattern.str().c_str()))
         {
             return tok;
         }
@@ -76,7 +76,11 @@ public:
     /** Set variable id */
     void setVarId();
 
-    /** Simplify tokenlist */
+    /**
+     * Simplify tokenlist. Between the simplifications some brackets may
+     * not be linked, see Token::link(). When this returns, all of them
+     * are linked.
+     */
     void simplifyTokenList();
 
     static void deleteTokens(Token *tok);
@@ -105,6 +109,16 @@ public:
      */
     static const Token *findClassFunction(const Token *tok, const char classname[], const char funcname[], int &indentlevel);
 
+    /**
+     * Finds matching "end" for "start". If the start tag is linked, the
+     * link is used and the block is skipped without walking through it.
+     * @param tok The start tag
+     * @param start e.g. "{"
+     * @param end e.g. "}"
+     * @return The end tag that matches given parameter or 0 if not found.
+     */
+    static const Token *findClosing(const Token *tok, const char *start, const char *end);
+
 private:
 
     /**
@@ -196,15 +210,6 @@ private:
 
     std::vector<const Token *> _functionList;
 
-    /**
-     * Finds matching "end" for "start".
-     * @param tok The start tag
-     * @param start e.g. "{"
-     * @param end e.g. "}"
-     * @return The end tag that matches given parameter or 0 if not found.
-     */
-    static const Token *findClosing(const Token *tok, const char *start, const char *end);
-
     void addtoken(const char str[], const unsigned int lineno, const unsigned int fileno);
 
     /**
@@ -0,0 +1,145 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2009 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/
+ */
+
+//---------------------------------------------------------------------------
+#include "tokenmatcher.h"
+#include "token.h"
+
+#include <cstring>
+//---------------------------------------------------------------------------
+
+TokenMatcher::TokenMatcher() : _size(0)
+{
+}
+
+void TokenMatcher::addPattern(const char pattern[], Listener *listener, unsigned int id, unsigned int varid)
+{
+    Entry entry;
+    entry.pattern = pattern;
+    entry.listener = listener;
+    entry.id = id;
+    entry.varid = varid;
+    ++_size;
+
+    // Extract the first token of the pattern..
+    const char *start = pattern;
+    while (*start == ' ')
+        ++start;
+    const char *end = strchr(start, ' ');
+    const std::string first(start, end ? static_cast<std::string::size_type>(end - start) : strlen(start));
+
+    if (first.empty())
+    {
+        _any.push_back(entry);
+    }
+
+    else if (first[0] == '%')
+    {
+        if (first == "%var%" || first == "%type%")
+            _names.push_back(entry);
+        else if (first == "%num%")
+            _numbers.push_back(entry);
+        else
+            _any.push_back(entry);
+    }
+
+    // "!!else" matches any token except "else"
+    else if (first.length() > 2 && first[0] == '!' && first[1] == '!')
+    {
+        _any.push_back(entry);
+    }
+
+    // "[;{}]" => one of the characters
+    else if (first[0] == '[' && first.length() > 2 && first[first.length() - 1] == ']')
+    {
+        for (std::string::size_type pos = 1; pos + 1 < first.length(); ++pos)
+            _literal[first.substr(pos, 1)].push_back(entry);
+    }
+
+    // "int|char" => one of the alternatives
+    else if (first.find("|") != std::string::npos && (first[0] != '|' || first.length() > 2))
+    {
+        std::vector<std::string> alternatives;
+        std::string::size_type pos1 = 0;
+        while (true)
+        {
+            const std::string::size_type pos2 = first.find("|", pos1);
+            if (pos2 == std::string::npos)
+            {
+                alternatives.push_back(first.substr(pos1));
+                break;
+            }
+            alternatives.push_back(first.substr(pos1, pos2 - pos1));
+            pos1 = pos2 + 1;
+        }
+
+        // An empty alternative means that the pattern can start anywhere,
+        // and an alternative such as "%var%" is not a literal string
+        bool any = false;
+        for (std::vector<std::string>::const_iterator it = alternatives.begin(); it != alternatives.end(); ++it)
+        {
+            if (it->empty() || (*it)[0] == '%')
+                any = true;
+        }
+
+        if (any)
+            _any.push_back(entry);
+        else
+        {
+            for (std::vector<std::string>::const_iterator it = alternatives.begin(); it != alternatives.end(); ++it)
+                _literal[*it].push_back(entry);
+        }
+    }
+
+    else
+    {
+        _literal[first].push_back(entry);
+    }
+}
+
+void TokenMatcher::matchEntries(const std::vector<Entry> &entries, const Token *tok)
+{
+    for (std::vector<Entry>::const_iterator it = entries.begin(); it != entries.end(); ++it)
+    {
+        if (Token::Match(tok, it->pattern, it->varid))
+            it->listener->patternMatch(tok, it->id);
+    }
+}
+
+void TokenMatcher::run(const Token *tokens) const
+{
+    if (_size == 0)
+        return;
+
+    for (const Token *tok = tokens; tok; tok = tok->next())
+    {
+        if (!_literal.empty())
+        {
+            std::map<std::string, std::vector<Entry> >::const_iterator it = _literal.find(tok->str());
+            if (it != _literal.end())
+                matchEntries(it->second, tok);
+        }
+
+        if (tok->isName())
+            matchEntries(_names, tok);
+        else if (tok->isNumber())
+            matchEntries(_numbers, tok);
+
+        matchEntries(_any, tok);
+    }
+}
@@ -0,0 +1,110 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2009 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/
+ */
+
+//---------------------------------------------------------------------------
+#ifndef tokenmatcherH
+#define tokenmatcherH
+//---------------------------------------------------------------------------
+
+#include <map>
+#include <string>
+#include <vector>
+
+class Token;
+
+/// @addtogroup Core
+/// @{
+
+/**
+ * @brief Match many Token::Match() patterns in one pass over the token list.
+ *
+ * The checks register the patterns they are interested in together with
+ * a listener. run() then walks the token list once and calls the listener
+ * at each position where a registered pattern matches. The patterns are
+ * indexed by the first token, so at each token only the patterns that can
+ * start there are tested.
+ */
+class TokenMatcher
+{
+public:
+    /** @brief Interface for the objects that are notified about the matches */
+    class Listener
+    {
+    public:
+        virtual ~Listener() { }
+
+        /**
+         * A registered pattern matched
+         * @param tok the first token of the match
+         * @param id the id that was given when the pattern was registered
+         */
+        virtual void patternMatch(const Token *tok, unsigned int id) = 0;
+    };
+
+    TokenMatcher();
+
+    /**
+     * Register a pattern.
+     * @param pattern a pattern for Token::Match(). The pattern string is
+     * not copied, it must be valid as long as the TokenMatcher is used.
+     * @param listener the object that is notified about the matches
+     * @param id given to the listener when the pattern matches
+     * @param varid varid for the %varid% pattern
+     */
+    void addPattern(const char pattern[], Listener *listener, unsigned int id, unsigned int varid = 0);
+
+    /** Walk through the tokens once and notify the listeners about all matches */
+    void run(const Token *tokens) const;
+
+    /** Number of registered patterns */
+    unsigned int size() const
+    {
+        return _size;
+    }
+
+private:
+    struct Entry
+    {
+        const char *pattern;
+        Listener *listener;
+        unsigned int id;
+        unsigned int varid;
+    };
+
+    /** Match the entries at the given token */
+    static void matchEntries(const std::vector<Entry> &entries, const Token *tok);
+
+    /** Patterns that start with a known string, e.g. "if (" or "strcpy|strcat (" */
+    std::map<std::string, std::vector<Entry> > _literal;
+
+    /** Patterns that start with %var% or %type% */
+    std::vector<Entry> _names;
+
+    /** Patterns that start with %num% */
+    std::vector<Entry> _numbers;
+
+    /** Patterns that can start anywhere, e.g. "%any%" or "!!else" */
+    std::vector<Entry> _any;
+
+    unsigned int _size;
+};
+
+/// @}
+
+//---------------------------------------------------------------------------
+#endif
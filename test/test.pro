@@ -30,15 +30,25 @@ HEADERS += testsuite.h \
            ../src/checkmemoryleak.h \
            ../src/preprocessor.h \
            ../src/checkstl.h \
-           ../src/checkheaders.h
+           ../src/checkheaders.h \
+           ../src/tokenmatcher.h \
+           ../src/errorqueue.h \
+           ../src/reportwriter.h \
+           ../src/compiledatabase.h \
+           ../src/filecache.h \
+           ../src/daemon.h \
+           ../src/filereader.h
 SOURCES += testautovariables.cpp \
            testbufferoverrun.cpp \
            testcharvar.cpp \
            testclass.cpp \
+           testcompiledatabase.cpp \
            testconstructors.cpp \
            testcppcheck.cpp \
            testdangerousfunctions.cpp \
            testdivision.cpp \
+           testerrorqueue.cpp \
+           testfilecache.cpp \
            testfilelister.cpp \
            testincompletestatement.cpp \
            testmathlib.cpp \
@@ -46,12 +56,14 @@ SOURCES += testautovariables.cpp \
            testother.cpp \
            testpreprocessor.cpp \
            testredundantif.cpp \
+           testreportwriter.cpp \
            testrunner.cpp \
            testsimplifytokens.cpp \
            teststl.cpp \
            testsuite.cpp \
            testtoken.cpp \
            testtokenize.cpp \
+           testtokenmatcher.cpp \
            testunusedfunctions.cpp \
            testunusedprivfunc.cpp \
            testunusedvar.cpp \
@@ -71,7 +83,15 @@ SOURCES += testautovariables.cpp \
            ../src/checkmemoryleak.cpp \
            ../src/preprocessor.cpp \
            ../src/checkstl.cpp \
-           ../src/CheckHeaders.cpp
+           ../src/CheckHeaders.cpp \
+           ../src/tokenmatcher.cpp \
+           ../src/errorqueue.cpp \
+           ../src/reportwriter.cpp \
+           ../src/compiledatabase.cpp \
+           ../src/filecache.cpp \
+           ../src/daemon.cpp
+
+unix:LIBS += -lpthread
 
 win32 {
     CONFIG += console
@@ -49,14 +49,25 @@ private:
         // Fill function list
         tokenizer.fillFunctionList();
 
+        // Check all the tokens..
+        errout.str("");
+        Settings settings;
+        settings._showAll = true;
+        CheckBufferOverrun checkAllTokens(&tokenizer, &settings, this);
+        checkAllTokens.allTokens();
+        checkAllTokens.bufferOverrun();
+        const std::string allTokensErrors(errout.str());
+
         // Clear the error buffer..
         errout.str("");
 
         // Check for buffer overruns..
-        Settings settings;
-        settings._showAll = true;
         CheckBufferOverrun checkBufferOverrun(&tokenizer, &settings, this);
         checkBufferOverrun.bufferOverrun();
+
+        // Only the tokens where the arrays are used are checked, that
+        // must give the same results
+        ASSERT_EQUALS(allTokensErrors, errout.str());
     }
 
     void run()
@@ -115,6 +126,8 @@ private:
         TEST_CASE(alloc);    // Buffer allocated with new
 
         TEST_CASE(memset1);
+
+        TEST_CASE(usagePositions);
     }
 
 
@@ -740,6 +753,105 @@ private:
               "}\n");
         ASSERT_EQUALS("[test.cpp:4]: (possible error) The size argument is given as a char constant\n", errout.str());
     }
+
+
+    void usagePositions()
+    {
+        // Only the tokens at the UsageOffset positions before a usage, the
+        // token before the "(" that a usage is in and the loops before the
+        // last usage are checked. Hit each of them with other code before
+        // the usage.
+
+        // array index - BeforeUsage
+        check("void foo()\n"
+              "{\n"
+              "    char s[10];\n"
+              "    int x = 0;\n"
+              "    x = s[10];\n"
+              "}\n");
+        ASSERT_EQUALS("[test.cpp:5]: (possible error) Array index out of bounds\n", errout.str());
+
+        // first argument - the token before the "("
+        check("void foo()\n"
+              "{\n"
+              "    char s[10];\n"
+              "    int x = 0;\n"
+              "    memset(s, 0, 20);\n"
+              "}\n");
+        ASSERT_EQUALS("[test.cpp:5]: (possible error) Buffer overrun\n", errout.str());
+
+        check("void foo()\n"
+              "{\n"
+              "    char s[10];\n"
+              "    int x = 0;\n"
+              "    strcpy(s, \"abcdefghijklmnopqrstuvwxyz\");\n"
+              "}\n");
+        ASSERT_EQUALS("[test.cpp:5]: (possible error) Buffer overrun\n", errout.str());
+
+        check("void foo()\n"
+              "{\n"
+              "    char s[10];\n"
+              "    int x = 0;\n"
+              "    sprintf(s, \"abcdefghijklmnopqrstuvwxyz\");\n"
+              "}\n");
+        ASSERT_EQUALS("[test.cpp:5]: (possible error) Buffer overrun\n", errout.str());
+
+        check("void foo()\n"
+              "{\n"
+              "    char s[10];\n"
+              "    int x = 0;\n"
+              "    snprintf(s, 20, \"%d\", x);\n"
+              "}\n");
+        ASSERT_EQUALS("[test.cpp:5]: (error) snprintf size is out of bounds\n", errout.str());
+
+        check("void foo()\n"
+              "{\n"
+              "    char s[10];\n"
+              "    int x = 0;\n"
+              "    strncat(s, a, 20);\n"
+              "}\n");
+        ASSERT_EQUALS("[test.cpp:5]: (possible error) Dangerous usage of strncat. Tip: the 3rd parameter means maximum number of characters to append\n", errout.str());
+
+        check("void foo()\n"
+              "{\n"
+              "    char s[10];\n"
+              "    int x = 0;\n"
+              "    std::cin >> s;\n"
+              "}\n");
+        ASSERT_EQUALS("[test.cpp:5]: (possible error) Buffer overrun\n", errout.str());
+
+        // second argument - the token before the "("
+        check("void foo()\n"
+              "{\n"
+              "    char s[10];\n"
+              "    char d[100];\n"
+              "    memcpy(d, s, 20);\n"
+              "}\n");
+        ASSERT_EQUALS("[test.cpp:5]: (possible error) Buffer overrun\n", errout.str());
+
+        // function call - the function name before the "(" of the usage
+        check("static void f(int i, char *p)\n"
+              "{\n"
+              "    p[10] = 0;\n"
+              "}\n"
+              "void foo()\n"
+              "{\n"
+              "    char s[10];\n"
+              "    int x = 0;\n"
+              "    f(x + 1, s);\n"
+              "}\n");
+        ASSERT_EQUALS("[test.cpp:9] -> [test.cpp:3]: (possible error) Array index out of bounds\n", errout.str());
+
+        // loop before the last usage
+        check("void foo()\n"
+              "{\n"
+              "    char s[10];\n"
+              "    int x = 0;\n"
+              "    for (int i = 0; i <= 10; i++)\n"
+              "        s[i] = 0;\n"
+              "}\n");
+        ASSERT_EQUALS("[test.cpp:6]: (possible error) Buffer overrun\n", errout.str());
+    }
 };
 
 REGISTER_TEST(TestBufferOverrun)
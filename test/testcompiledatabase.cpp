@@ -0,0 +1,105 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2009 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/
+ */
+
+
+#include "testsuite.h"
+#include "../src/compiledatabase.h"
+
+#include <sstream>
+
+class TestCompileDatabase : public TestFixture
+{
+public:
+    TestCompileDatabase() : TestFixture("TestCompileDatabase")
+    { }
+
+private:
+
+    void run()
+    {
+        TEST_CASE(splitCommand);
+        TEST_CASE(fileSettings);
+        TEST_CASE(load);
+        TEST_CASE(loadArguments);
+        TEST_CASE(syntaxError);
+    }
+
+    static std::string join(const std::list<std::string> &strings)
+    {
+        std::string ret;
+        for (std::list<std::string>::const_iterator it = strings.begin(); it != strings.end(); ++it)
+            ret += "[" + *it + "]";
+        return ret;
+    }
+
+    void splitCommand()
+    {
+        ASSERT_EQUALS("[g++][-c][main.cpp]", join(CompileDatabase::splitCommand("g++  -c\tmain.cpp ")));
+        ASSERT_EQUALS("[-DA=a b][-DB=\"x\"]", join(CompileDatabase::splitCommand("-DA=\"a b\" '-DB=\"x\"'")));
+        ASSERT_EQUALS("[-DA=\"1\"][a b][c\\d]", join(CompileDatabase::splitCommand("-DA=\\\"1\\\" a\\ b \"c\\d\"")));
+        ASSERT_EQUALS("[]", join(CompileDatabase::splitCommand("''")));
+    }
+
+    void fileSettings()
+    {
+        const Settings::FileSettings fs(CompileDatabase::getFileSettings(CompileDatabase::splitCommand("gcc -DA -D B=2 -DC -UC -I inc -I/usr/inc/ -iquote../q -o x.o -c x.c"), "/p/build/"));
+        ASSERT_EQUALS("A=1;B=2", fs._cfg);
+        ASSERT_EQUALS("[/p/build/inc/][/usr/inc/][/p/q/]", join(fs._includePaths));
+    }
+
+    void load()
+    {
+        std::istringstream istr("[\n"
+                                "  { \"directory\": \"/p/build\",\n"
+                                "    \"command\": \"g++ -DDEBUG -I../include -c ../src/main.cpp\",\n"
+                                "    \"file\": \"../src/main.cpp\" },\n"
+                                "  { \"directory\": \"/p/build\", \"file\": \"/p/src/main.cpp\", \"command\": \"g++ -c main.cpp\" },\n"
+                                "  { \"directory\": \"/p\", \"file\": \"a.c\", \"command\": \"gcc -c a.c\", \"output\": [1, true, null, {\"a\": -1.5e3}] }\n"
+                                "]\n");
+        std::map<std::string, Settings::FileSettings> fileSettings;
+        ASSERT_EQUALS("", CompileDatabase::load(istr, fileSettings));
+        ASSERT_EQUALS(2, static_cast<int>(fileSettings.size()));
+        ASSERT_EQUALS("DEBUG=1", fileSettings["/p/src/main.cpp"]._cfg);
+        ASSERT_EQUALS("[/p/include/]", join(fileSettings["/p/src/main.cpp"]._includePaths));
+        ASSERT_EQUALS("", fileSettings["/p/a.c"]._cfg);
+    }
+
+    void loadArguments()
+    {
+        std::istringstream istr("[{\"directory\":\"/p/\",\"arguments\":[\"gcc\",\"-DNAME=\\\"a b\\\"\",\"-I\",\"inc\\u00e4\"],\"file\":\"a.c\"}]");
+        std::map<std::string, Settings::FileSettings> fileSettings;
+        ASSERT_EQUALS("", CompileDatabase::load(istr, fileSettings));
+        ASSERT_EQUALS("NAME=\"a b\"", fileSettings["/p/a.c"]._cfg);
+        ASSERT_EQUALS("[/p/inc\xc3\xa4/]", join(fileSettings["/p/a.c"]._includePaths));
+    }
+
+    void syntaxError()
+    {
+        std::map<std::string, Settings::FileSettings> fileSettings;
+        std::istringstream istr1("{}");
+        ASSERT_EQUALS("syntax error in the compilation database at character 0", CompileDatabase::load(istr1, fileSettings));
+        std::istringstream istr2("[{\"file\":\"a.c\"} {}]");
+        ASSERT_EQUALS("syntax error in the compilation database at character 16", CompileDatabase::load(istr2, fileSettings));
+        std::istringstream istr3("[{\"file\":\"a.c");
+        ASSERT_EQUALS("syntax error in the compilation database at character 13", CompileDatabase::load(istr3, fileSettings));
+        std::istringstream istr4("[{\"directory\":\"/p\"}]");
+        ASSERT_EQUALS("there is no \"file\" in a command of the compilation database", CompileDatabase::load(istr4, fileSettings));
+    }
+};
+
+REGISTER_TEST(TestCompileDatabase)
@@ -76,6 +76,8 @@ private:
         TEST_CASE(initvar_destructor);      // No variables need to be initialized in a destructor
 
         TEST_CASE(operatorEqSTL);
+
+        TEST_CASE(uninitVarOrder);          // The members are reported in declaration order
     }
 
 
@@ -384,6 +386,22 @@ private:
               "{ }", true);
         ASSERT_EQUALS("[test.cpp:13]: (possible style) Member variable 'Fred::ints' is not assigned a value in 'Fred::operator='\n", errout.str());
     }
+
+    void uninitVarOrder()
+    {
+        check("class Fred\n"
+              "{\n"
+              "public:\n"
+              "    Fred() { b = 0; }\n"
+              "    int c;\n"
+              "    int a;\n"
+              "    int b;\n"
+              "    int d;\n"
+              "};\n");
+        ASSERT_EQUALS("[test.cpp:4]: (style) Member variable not initialized in the constructor 'Fred::c'\n"
+                      "[test.cpp:4]: (style) Member variable not initialized in the constructor 'Fred::a'\n"
+                      "[test.cpp:4]: (style) Member variable not initialized in the constructor 'Fred::d'\n", errout.str());
+    }
 };
 
 REGISTER_TEST(TestConstructors)
@@ -23,10 +23,20 @@
 
 #include "testsuite.h"
 #include "../src/cppcheck.h"
+#include "../src/filereader.h"
 
+#include <cstdio>
+#include <fstream>
 #include <map>
 #include <string>
 
+#if defined(__GNUC__) && !defined(__MINGW32__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 extern std::ostringstream errout;
 
 class TestCppcheck : public TestFixture
@@ -37,10 +47,14 @@ public:
 
 private:
 
-    void check(const std::string &data)
+    void check(const std::string &data, unsigned int checkThreads = 1)
     {
         errout.str("");
         CppCheck cppCheck(*this);
+        Settings settings;
+        settings._checkCodingStyle = true;
+        settings._checkThreads = checkThreads;
+        cppCheck.settings(settings);
         cppCheck.addFile("file.cpp", data);
         cppCheck.check();
     }
@@ -53,6 +67,15 @@ private:
         TEST_CASE(xml);
 
         TEST_CASE(include);
+
+        TEST_CASE(checkThreads);
+        TEST_CASE(checkThreadsExclusive);
+
+        TEST_CASE(fileReader);
+        TEST_CASE(terminate);
+        TEST_CASE(terminateFromThread);
+        TEST_CASE(progress);
+        TEST_CASE(summaries);
     }
 
     void linenumbers()
@@ -94,6 +117,331 @@ private:
     }
 
 
+    void checkThreads()
+    {
+        const char filedata[] = "class Fred\n"
+                                "{\n"
+                                "public:\n"
+                                "    Fred() { }\n"
+                                "    int i;\n"
+                                "};\n"
+                                "void f(char *s)\n"
+                                "{\n"
+                                "    char *p = new char[10];\n"
+                                "    char a[10];\n"
+                                "    a[10] = 0;\n"
+                                "    gets(s);\n"
+                                "    int x = 3 / 0;\n"
+                                "}\n";
+
+        // The messages must be reported in the same order by the threads
+        check(filedata);
+        const std::string expected(errout.str());
+        ASSERT_EQUALS(false, expected.empty());
+
+        check(filedata, 4);
+        ASSERT_EQUALS(expected, errout.str());
+    }
+
+    void checkThreadsExclusive()
+    {
+        // The memory leaks are checked alone, the constructors at the same
+        // time as the other checks
+        check("class Fred\n"
+              "{\n"
+              "public:\n"
+              "    Fred() { }\n"
+              "    int i;\n"
+              "};\n"
+              "void f()\n"
+              "{\n"
+              "    char *p = new char[10];\n"
+              "}\n", 4);
+        ASSERT_EQUALS("[file.cpp:4]: (style) Member variable not initialized in the constructor 'Fred::i'\n"
+                      "[file.cpp:10]: (error) Memory leak: p\n", errout.str());
+    }
+
+    /** Files that are read from memory */
+    class MemoryFileReader : public FileReader
+    {
+    public:
+        std::map<std::string, std::string> files;
+
+        bool read(const std::string &filename, std::string &code)
+        {
+            std::map<std::string, std::string>::const_iterator it = files.find(filename);
+            if (it == files.end())
+                return false;
+            code = it->second;
+            return true;
+        }
+    };
+
+    void fileReader()
+    {
+        MemoryFileReader reader;
+        reader.files["memory/main.cpp"] = "#include \"main.h\"\n"
+                                          "void f()\n"
+                                          "{\n"
+                                          "    char *s = new char[SIZE];\n"
+                                          "}\n";
+        reader.files["memory/inc/main.h"] = "#define SIZE 10\n"
+                                            "void g() { char *p = new char[SIZE]; }\n";
+        reader.files["memory/gen/a.cpp"] = "void f() { char *a = new char[10]; }\n";
+
+        errout.str("");
+        CppCheck cppCheck(*this);
+        Settings settings;
+        settings._includePaths.push_back("memory/inc/");
+        settings._exclude.push_back("memory/gen");
+        cppCheck.settings(settings);
+
+        // The reader is used when the checking starts. The excluded
+        // files and the files that are not source files are skipped.
+        cppCheck.addFile("memory/main.cpp");
+        cppCheck.addFile("memory/gen/a.cpp");
+        cppCheck.addFile("memory/inc/main.h");
+        cppCheck.fileReader(&reader);
+        cppCheck.check();
+
+        // The files are not in the file system
+        ASSERT_EQUALS("[memory/inc/main.h:2]: (error) Memory leak: p\n"
+                      "[memory/main.cpp:5]: (error) Memory leak: s\n", errout.str());
+    }
+
+    /** Terminates the checking when a given file is read */
+    class TerminatingFileReader : public MemoryFileReader
+    {
+    public:
+        CppCheck *cppCheck;
+        std::string terminateFile;
+
+        bool read(const std::string &filename, std::string &code)
+        {
+            if (filename == terminateFile)
+                cppCheck->terminate();
+            return MemoryFileReader::read(filename, code);
+        }
+    };
+
+    void terminate()
+    {
+        errout.str("");
+        CppCheck cppCheck(*this);
+        TerminatingFileReader reader;
+        reader.cppCheck = &cppCheck;
+        reader.terminateFile = "b.h";
+        reader.files["b.h"] = "void g() { }\n";
+
+        cppCheck.settings(Settings());
+        cppCheck.fileReader(&reader);
+        cppCheck.addFile("a.cpp", "void f()\n{\n    char *a = new char[10];\n}\n");
+        cppCheck.addFile("b.cpp", "#include \"b.h\"\nvoid f()\n{\n    char *b = new char[10];\n}\n");
+        cppCheck.addFile("c.cpp", "void f()\n{\n    char *c = new char[10];\n}\n");
+        cppCheck.check();
+
+        // The checking stops when b.h is included
+        ASSERT_EQUALS("[a.cpp:4]: (error) Memory leak: a\n", errout.str());
+    }
+
+#if defined(__GNUC__) && !defined(__MINGW32__)
+    /** Waits in the reading of a given file until the checking is terminated */
+    class WaitingFileReader : public MemoryFileReader
+    {
+    public:
+        std::string waitFile;
+        volatile int waiting;
+        volatile int terminated;
+
+        WaitingFileReader() : waiting(0), terminated(0)
+        { }
+
+        bool read(const std::string &filename, std::string &code)
+        {
+            if (filename == waitFile)
+            {
+                __sync_lock_test_and_set(&waiting, 1);
+                while (__sync_val_compare_and_swap(&terminated, 0, 0) == 0)
+                    sched_yield();
+            }
+            return MemoryFileReader::read(filename, code);
+        }
+    };
+
+    static void *checkThread(void *cppCheck)
+    {
+        static_cast<CppCheck *>(cppCheck)->check();
+        return 0;
+    }
+#endif
+
+    void terminateFromThread()
+    {
+#if defined(__GNUC__) && !defined(__MINGW32__)
+        errout.str("");
+        CppCheck cppCheck(*this);
+        WaitingFileReader reader;
+        reader.waitFile = "b.h";
+        reader.files["b.h"] = "void g() { }\n";
+
+        cppCheck.settings(Settings());
+        cppCheck.fileReader(&reader);
+        cppCheck.addFile("a.cpp", "void f()\n{\n    char *a = new char[10];\n}\n");
+        cppCheck.addFile("b.cpp", "#include \"b.h\"\nvoid f()\n{\n    char *b = new char[10];\n}\n");
+        cppCheck.addFile("c.cpp", "void f()\n{\n    char *c = new char[10];\n}\n");
+
+        // Check in another thread, and stop the checking from this thread
+        // when b.h is read
+        pthread_t thread;
+        ASSERT_EQUALS(0, pthread_create(&thread, 0, checkThread, &cppCheck));
+        while (__sync_val_compare_and_swap(&reader.waiting, 0, 0) == 0)
+            sched_yield();
+        cppCheck.terminate();
+        __sync_lock_test_and_set(&reader.terminated, 1);
+        pthread_join(thread, 0);
+
+        ASSERT_EQUALS("[a.cpp:4]: (error) Memory leak: a\n", errout.str());
+#endif
+    }
+
+    /** Records the phases that are reported, except the checks */
+    class ProgressLogger : public ErrorLogger
+    {
+    public:
+        std::ostringstream progress;
+        unsigned int checks;
+
+        ProgressLogger() : checks(0)
+        { }
+
+        void reportOut(const std::string &)
+        { }
+
+        void reportErr(const ErrorLogger::ErrorMessage &)
+        { }
+
+        void reportStatus(unsigned int, unsigned int)
+        { }
+
+        void reportProgress(const std::string &filename, const std::string &stage, unsigned int cfg, unsigned int cfgCount, unsigned int value)
+        {
+            if (stage.compare(0, 5, "check") == 0)
+                ++checks;
+            else
+                progress << filename << " " << cfg << "/" << cfgCount << " " << stage << " " << value << "\n";
+        }
+    };
+
+    void progress()
+    {
+        ProgressLogger logger;
+        CppCheck cppCheck(logger);
+        cppCheck.settings(Settings());
+        cppCheck.addFile("file.cpp", "#ifdef A\n"
+                         "int a;\n"
+                         "#endif\n");
+        cppCheck.check();
+
+        ASSERT_EQUALS("file.cpp 1/2 preprocess 23\n"
+                      "file.cpp 1/2 tokenize 3\n"
+                      "file.cpp 1/2 simplify 0\n"
+                      "file.cpp 1/2 match 0\n"
+                      "file.cpp 2/2 preprocess 23\n"
+                      "file.cpp 2/2 tokenize 9\n"
+                      "file.cpp 2/2 simplify 3\n"
+                      "file.cpp 2/2 match 3\n", logger.progress.str());
+        ASSERT_EQUALS(true, logger.checks > 0);
+    }
+
+    /** The scratch directory of the summaries test */
+    static const char *summaryDir()
+    {
+        return "testcppcheck-summaries/";
+    }
+
+    void checkSummaries(CppCheck &cppCheck, const char code1[], const char code2[])
+    {
+        errout.str("");
+        cppCheck.clearFiles();
+        cppCheck.addFile("summaries/a/b_c.c", code1);
+        cppCheck.addFile("summaries/a_b/c.c", code2);
+        cppCheck.check();
+    }
+
+    void checkSummaries(const char code1[], const char code2[])
+    {
+        CppCheck cppCheck(*this);
+        Settings settings;
+        settings._summaryDir = summaryDir();
+        cppCheck.settings(settings);
+        checkSummaries(cppCheck, code1, code2);
+    }
+
+    void summaries()
+    {
+#if defined(__GNUC__) && !defined(__MINGW32__)
+        const std::string summary1(std::string(summaryDir()) + "summaries_2fa_2fb_5fc.c.summary");
+        const std::string summary2(std::string(summaryDir()) + "summaries_2fa_5fb_2fc.c.summary");
+        std::remove(summary1.c_str());
+        std::remove(summary2.c_str());
+        mkdir(summaryDir(), 0755);
+
+        const char code1[] = "char *a()\n"
+                             "{\n"
+                             "    return new char[10];\n"
+                             "}\n";
+        const char code2[] = "void f()\n"
+                             "{\n"
+                             "    char *p = a();\n"
+                             "    char *q = x();\n"
+                             "}\n";
+
+        // The summaries are written and then used in the other file
+        checkSummaries(code1, code2);
+        ASSERT_EQUALS("[summaries/a_b/c.c:5]: (error) Memory leak: p\n", errout.str());
+
+        // The paths don't get the same summary file
+        std::string header;
+        {
+            std::ifstream fin1(summary1.c_str());
+            std::ifstream fin2(summary2.c_str());
+            ASSERT_EQUALS(true, fin1.is_open());
+            ASSERT_EQUALS(true, fin2.is_open());
+            std::getline(fin1, header);
+        }
+
+        // The summary of code that has not changed is reused: the
+        // allocation in x() is only known from the summary file
+        {
+            std::ofstream fout(summary1.c_str());
+            fout << header << "\n" << "alloc x 4\n";
+        }
+        checkSummaries(code1, code2);
+        ASSERT_EQUALS("[summaries/a_b/c.c:5]: (error) Memory leak: q\n", errout.str());
+
+        // The summaries are made once per run: the next check() of the
+        // same CppCheck doesn't write them again
+        {
+            CppCheck cppCheck(*this);
+            Settings settings;
+            settings._summaryDir = summaryDir();
+            cppCheck.settings(settings);
+            checkSummaries(cppCheck, code1, code2);
+            ASSERT_EQUALS("[summaries/a_b/c.c:5]: (error) Memory leak: q\n", errout.str());
+
+            std::remove(summary1.c_str());
+            std::remove(summary2.c_str());
+            checkSummaries(cppCheck, code1, code2);
+            ASSERT_EQUALS("[summaries/a_b/c.c:5]: (error) Memory leak: q\n", errout.str());
+            ASSERT_EQUALS(false, std::ifstream(summary1.c_str()).is_open());
+        }
+
+        std::remove(summary1.c_str());
+        std::remove(summary2.c_str());
+        rmdir(summaryDir());
+#endif
+    }
+
     void include()
     {
         ErrorLogger::ErrorMessage errmsg;
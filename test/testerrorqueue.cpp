@@ -0,0 +1,153 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2009 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/
+ */
+
+
+#include "testsuite.h"
+#include "../src/errorqueue.h"
+
+#include <sstream>
+
+#if defined(__GNUC__) && !defined(__MINGW32__)
+#include <pthread.h>
+#endif
+
+class TestErrorQueue : public TestFixture
+{
+public:
+    TestErrorQueue() : TestFixture("TestErrorQueue")
+    { }
+
+private:
+    /** The reported messages */
+    std::ostringstream reported;
+
+    void reportOut(const std::string &outmsg)
+    {
+        reported << outmsg << " ";
+    }
+
+    void reportErr(const ErrorLogger::ErrorMessage &msg)
+    {
+        reported << "[" << msg._msg << "] ";
+    }
+
+    void run()
+    {
+        TEST_CASE(buffer);
+        TEST_CASE(order);
+        TEST_CASE(threads);
+    }
+
+    static ErrorLogger::ErrorMessage errmsg(const std::string &msg)
+    {
+        return ErrorLogger::ErrorMessage(std::list<ErrorLogger::ErrorMessage::FileLocation>(), "error", msg, "id");
+    }
+
+    void buffer()
+    {
+        // The messages are reported in the order they were written
+        ErrorQueue::Buffer buffer(0);
+        buffer.reportOut("a");
+        buffer.reportErr(errmsg("b"));
+        buffer.reportOut("c");
+
+        reported.str("");
+        buffer.report(*this);
+        ASSERT_EQUALS("a [b] c ", reported.str());
+    }
+
+    void order()
+    {
+        ErrorQueue errors;
+        ErrorQueue::Buffer *buffer;
+        reported.str("");
+
+        // Buffer 1 must wait for buffer 0
+        buffer = new ErrorQueue::Buffer(1);
+        buffer->reportOut("1");
+        errors.push(buffer);
+        ASSERT_EQUALS(0, errors.flush(*this));
+        ASSERT_EQUALS("", reported.str());
+
+        buffer = new ErrorQueue::Buffer(2);
+        buffer->reportOut("2");
+        errors.push(buffer);
+        buffer = new ErrorQueue::Buffer(0);
+        buffer->reportOut("0");
+        errors.push(buffer);
+        ASSERT_EQUALS(3, errors.flush(*this));
+        ASSERT_EQUALS("0 1 2 ", reported.str());
+        ASSERT_EQUALS(3, errors.next());
+
+        // Buffers that are never flushed are deleted by the queue
+        errors.push(new ErrorQueue::Buffer(5));
+    }
+
+#if defined(__GNUC__) && !defined(__MINGW32__)
+    struct Producer
+    {
+        ErrorQueue *errors;
+        unsigned int first;
+    };
+
+    /** push every fourth buffer, starting from "first" */
+    static void *produce(void *arg)
+    {
+        Producer *producer = static_cast<Producer *>(arg);
+        for (unsigned int i = producer->first; i < 200; i += 4)
+        {
+            ErrorQueue::Buffer *buffer = new ErrorQueue::Buffer(i);
+            std::ostringstream ostr;
+            ostr << i;
+            buffer->reportOut(ostr.str());
+            producer->errors->push(buffer);
+        }
+        return 0;
+    }
+#endif
+
+    void threads()
+    {
+#if defined(__GNUC__) && !defined(__MINGW32__)
+        ErrorQueue errors;
+        Producer producers[4];
+        pthread_t threads[4];
+        for (unsigned int i = 0; i < 4; ++i)
+        {
+            producers[i].errors = &errors;
+            producers[i].first = i;
+            pthread_create(&threads[i], 0, produce, &producers[i]);
+        }
+
+        reported.str("");
+        unsigned int count = 0;
+        while (count < 200)
+            count += errors.flush(*this);
+
+        for (unsigned int i = 0; i < 4; ++i)
+            pthread_join(threads[i], 0);
+
+        std::ostringstream expected;
+        for (unsigned int i = 0; i < 200; ++i)
+            expected << i << " ";
+        ASSERT_EQUALS(expected.str(), reported.str());
+#endif
+    }
+};
+
+REGISTER_TEST(TestErrorQueue)
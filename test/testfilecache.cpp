@@ -0,0 +1,227 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2009 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/
+ */
+
+
+#include "testsuite.h"
+#include "../src/filecache.h"
+#include "../src/cppcheck.h"
+
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+
+#if defined(__GNUC__) && !defined(__MINGW32__)
+#include <sys/types.h>
+#include <utime.h>
+#endif
+
+extern std::ostringstream errout;
+
+class TestFileCache : public TestFixture
+{
+public:
+    TestFileCache() : TestFixture("TestFileCache")
+    { }
+
+private:
+    FileCache fileCache;
+
+    /** The number of times that the checking of a file has started */
+    unsigned int checkCount;
+
+    virtual void reportProgress(const std::string &/*filename*/, const std::string &stage, unsigned int /*cfg*/, unsigned int /*cfgCount*/, unsigned int /*value*/)
+    {
+        if (stage == "preprocess")
+            ++checkCount;
+    }
+
+    void check(const std::string &data, const Settings &settings = Settings())
+    {
+        errout.str("");
+        checkCount = 0;
+        CppCheck cppCheck(*this);
+        cppCheck.settings(settings);
+        cppCheck.fileCache(&fileCache);
+        cppCheck.addFile("file.cpp", data);
+        cppCheck.check();
+    }
+
+    void run()
+    {
+        TEST_CASE(results);
+        TEST_CASE(checkTwice);
+        TEST_CASE(summariesChanged);
+        TEST_CASE(readChanged);
+        TEST_CASE(evict);
+    }
+
+    void results()
+    {
+        FileCache cache;
+        std::list<ErrorLogger::ErrorMessage> messages;
+        messages.push_back(ErrorLogger::ErrorMessage());
+        cache.results("file.cpp", "int a;\n", messages);
+
+        ASSERT_EQUALS(true, cache.results("file.cpp", "int a;\n") != 0);
+        ASSERT_EQUALS(1, static_cast<int>(cache.results("file.cpp", "int a;\n")->size()));
+
+        // The code has changed..
+        ASSERT_EQUALS(true, cache.results("file.cpp", "int b;\n") == 0);
+        ASSERT_EQUALS(true, cache.results("file2.cpp", "int a;\n") == 0);
+
+        // Only the digest of the code is kept
+        ASSERT_EQUALS("811c9dc5 0", FileCache::digest(""));
+        ASSERT_EQUALS(false, FileCache::digest("int a;\n") == FileCache::digest("int b;\n"));
+
+        cache.clear();
+        ASSERT_EQUALS(true, cache.results("file.cpp", "int a;\n") == 0);
+    }
+
+    void checkTwice()
+    {
+        fileCache.clear();
+        const char code[] = "void f()\n"
+                            "{\n"
+                            "    char *p = new char[10];\n"
+                            "}\n";
+
+        check(code);
+        ASSERT_EQUALS("[file.cpp:4]: (error) Memory leak: p\n", errout.str());
+        ASSERT_EQUALS(1, checkCount);
+
+        // The results are cached..
+        check(code);
+        ASSERT_EQUALS("[file.cpp:4]: (error) Memory leak: p\n", errout.str());
+        ASSERT_EQUALS(0, checkCount);
+
+        // ..and the file is checked again when it changes
+        check("void f()\n"
+              "{\n"
+              "    char *p = new char[10];\n"
+              "    delete [] p;\n"
+              "}\n");
+        ASSERT_EQUALS("", errout.str());
+        ASSERT_EQUALS(1, checkCount);
+    }
+
+    void summariesChanged()
+    {
+        fileCache.clear();
+        const char code[] = "void f()\n"
+                            "{\n"
+                            "    char *p = a();\n"
+                            "}\n";
+
+        check(code);
+        ASSERT_EQUALS("", errout.str());
+        ASSERT_EQUALS(1, checkCount);
+
+        // The summary of an other file has changed => the file is checked again
+        Settings settings;
+        settings._allocFunctions["a"] = 4;
+        settings._summaryHeaders = "cppcheck-summary 1234abcd 32\n";
+        check(code, settings);
+        ASSERT_EQUALS("[file.cpp:4]: (error) Memory leak: p\n", errout.str());
+        ASSERT_EQUALS(1, checkCount);
+
+        check(code, settings);
+        ASSERT_EQUALS("[file.cpp:4]: (error) Memory leak: p\n", errout.str());
+        ASSERT_EQUALS(0, checkCount);
+    }
+
+    static void write(const char filename[], const char code[])
+    {
+        std::ofstream fout(filename);
+        fout << code;
+    }
+
+    void readChanged()
+    {
+#if defined(__GNUC__) && !defined(__MINGW32__)
+        const char filename[] = "testfilecache.h";
+        struct utimbuf times;
+        times.actime = times.modtime = 1000000000;
+
+        FileCache cache;
+        std::string code;
+        ASSERT_EQUALS(false, cache.read(filename, code));
+
+        write(filename, "int a;\n");
+        utime(filename, &times);
+        ASSERT_EQUALS(true, cache.read(filename, code));
+        ASSERT_EQUALS("int a;\n", code);
+
+        // The modification time and size are the same => the file is not read again
+        write(filename, "int b;\n");
+        utime(filename, &times);
+        ASSERT_EQUALS(true, cache.read(filename, code));
+        ASSERT_EQUALS("int a;\n", code);
+
+        // The modification time has changed..
+        times.modtime += 1;
+        utime(filename, &times);
+        ASSERT_EQUALS(true, cache.read(filename, code));
+        ASSERT_EQUALS("int b;\n", code);
+
+        // The size has changed..
+        write(filename, "int bc;\n");
+        utime(filename, &times);
+        ASSERT_EQUALS(true, cache.read(filename, code));
+        ASSERT_EQUALS("int bc;\n", code);
+
+        std::remove(filename);
+#endif
+    }
+
+    void evict()
+    {
+#if defined(__GNUC__) && !defined(__MINGW32__)
+        const char filename1[] = "testfilecache1.h";
+        const char filename2[] = "testfilecache2.h";
+        struct utimbuf times;
+        times.actime = times.modtime = 1000000000;
+
+        // Only one of the files fits in the cache
+        FileCache cache(10);
+        std::string code;
+        write(filename1, "int a;\n");
+        utime(filename1, &times);
+        ASSERT_EQUALS(true, cache.read(filename1, code));
+        write(filename2, "int b;\n");
+        utime(filename2, &times);
+        ASSERT_EQUALS(true, cache.read(filename2, code));
+
+        // The file that was read last is kept..
+        write(filename2, "int d;\n");
+        utime(filename2, &times);
+        ASSERT_EQUALS(true, cache.read(filename2, code));
+        ASSERT_EQUALS("int b;\n", code);
+
+        // ..and the other file is read again
+        write(filename1, "int c;\n");
+        utime(filename1, &times);
+        ASSERT_EQUALS(true, cache.read(filename1, code));
+        ASSERT_EQUALS("int c;\n", code);
+
+        std::remove(filename1);
+        std::remove(filename2);
+#endif
+    }
+};
+
+REGISTER_TEST(TestFileCache)
@@ -17,9 +17,17 @@
  */
 
 #include <string>
+#include <vector>
+#include <cstdio>
+#include <fstream>
 #include "testsuite.h"
 #include "../src/filelister.h"
 
+#if defined(__GNUC__) && !defined(__MINGW32__)
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 class TestFileLister : public TestFixture
 {
 public:
@@ -31,6 +39,8 @@ private:
     void run()
     {
         TEST_CASE(simplify_path);
+        TEST_CASE(excluded);
+        TEST_CASE(recursiveAddFiles);
     }
 
     void simplify_path()
@@ -47,6 +57,74 @@ private:
         ASSERT_EQUALS("../path/index.h", FileLister::simplifyPath("../path/other/../index.h"));
     }
 
+    void excluded()
+    {
+        std::list<std::string> exclude;
+        ASSERT_EQUALS(false, FileLister::excluded("src/main.cpp", exclude));
+
+        // path
+        exclude.push_back("src/gen");
+        ASSERT_EQUALS(true, FileLister::excluded("src/gen/", exclude));
+        ASSERT_EQUALS(true, FileLister::excluded("./src/gen", exclude));
+        ASSERT_EQUALS(true, FileLister::excluded("src/gen/a/b.cpp", exclude));
+        ASSERT_EQUALS(false, FileLister::excluded("src/generated.cpp", exclude));
+        ASSERT_EQUALS(false, FileLister::excluded("lib/src/gen/a.cpp", exclude));
+
+        // name
+        exclude.clear();
+        exclude.push_back("build");
+        ASSERT_EQUALS(true, FileLister::excluded("lib/build/", exclude));
+        ASSERT_EQUALS(true, FileLister::excluded("build/a.cpp", exclude));
+        ASSERT_EQUALS(false, FileLister::excluded("/home/build/src/a.cpp", exclude));
+        ASSERT_EQUALS(false, FileLister::excluded("lib/builder/", exclude));
+
+        // pattern
+        exclude.clear();
+        exclude.push_back("*_generated.c?");
+        exclude.push_back("third_*");
+        ASSERT_EQUALS(true, FileLister::excluded("src/a_generated.cc", exclude));
+        ASSERT_EQUALS(false, FileLister::excluded("src/a_generated.cpp", exclude));
+        ASSERT_EQUALS(true, FileLister::excluded("src/third_party/", exclude));
+        ASSERT_EQUALS(false, FileLister::excluded("src/my_third_party/", exclude));
+    }
+
+    void recursiveAddFiles()
+    {
+#if defined(__GNUC__) && !defined(__MINGW32__)
+        mkdir("filelister", 0755);
+        mkdir("filelister/sub", 0755);
+        std::ofstream("filelister/a.cpp");
+        std::ofstream("filelister/b.txt");
+        std::ofstream("filelister/sub/c.cpp");
+
+        // The source files in the directory and its subdirectories..
+        std::vector<std::string> filenames;
+        FileLister::recursiveAddFiles(filenames, "filelister/", true);
+        ASSERT_EQUALS(2, filenames.size());
+        if (filenames.size() == 2)
+        {
+            ASSERT_EQUALS("filelister/a.cpp", filenames[0]);
+            ASSERT_EQUALS("filelister/sub/c.cpp", filenames[1]);
+        }
+
+        // All the files in the directory..
+        filenames.clear();
+        FileLister::recursiveAddFiles(filenames, "filelister/", false);
+        ASSERT_EQUALS(2, filenames.size());
+        if (filenames.size() == 2)
+        {
+            ASSERT_EQUALS("filelister/a.cpp", filenames[0]);
+            ASSERT_EQUALS("filelister/b.txt", filenames[1]);
+        }
+
+        std::remove("filelister/sub/c.cpp");
+        std::remove("filelister/b.txt");
+        std::remove("filelister/a.cpp");
+        rmdir("filelister/sub");
+        rmdir("filelister");
+#endif
+    }
+
 
 };
 
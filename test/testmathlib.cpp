@@ -43,6 +43,14 @@ private:
         ASSERT_EQUALS("-11.96", MathLib::multiply("-2.3", "5.2"));
         ASSERT_EQUALS("7", MathLib::divide("21.", "3"));
         ASSERT_EQUALS("1", MathLib::divide("3", "2"));
+
+        // integers
+        ASSERT_EQUALS(256, MathLib::calculate(255L, 1L, '+'));
+        ASSERT_EQUALS(-3, MathLib::calculate(2L, 5L, '-'));
+        ASSERT_EQUALS(-12, MathLib::calculate(-3L, 4L, '*'));
+        ASSERT_EQUALS(1, MathLib::calculate(3L, 2L, '/'));
+        ASSERT_EQUALS(-1, MathLib::calculate(-3L, 2L, '/'));
+        ASSERT_EQUALS(0, MathLib::calculate(3L, 2L, '%'));
     }
 
     void convert()
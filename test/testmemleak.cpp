@@ -46,7 +46,8 @@ private:
         std::istringstream istr(code);
         tokenizer.tokenize(istr, "test.cpp");
 
-        return ((const CheckMemoryLeak *)0)->functionReturnType(tokenizer.tokens());
+        const CheckMemoryLeak checkMemoryLeak(&tokenizer, this);
+        return checkMemoryLeak.functionReturnType(tokenizer.tokens());
     }
 
     void testFunctionReturnType()
@@ -93,7 +94,7 @@ public:
     { }
 
 private:
-    void check(const char code[], bool showAll = false)
+    void check(const char code[], bool showAll = false, const Settings &summaries = Settings())
     {
         // Tokenize..
         Tokenizer tokenizer;
@@ -106,7 +107,7 @@ private:
         errout.str("");
 
         // Check for memory leaks..
-        Settings settings;
+        Settings settings(summaries);
         settings._debug = true;
         settings._showAll = showAll;
         tokenizer.fillFunctionList();
@@ -207,6 +208,8 @@ private:
         TEST_CASE(func13);
         TEST_CASE(func14);
         TEST_CASE(func15);
+        TEST_CASE(func16);      // The same function is called several times
+        TEST_CASE(summary);     // Functions in other files
 
         TEST_CASE(allocfunc1);
         TEST_CASE(allocfunc2);
@@ -1516,7 +1519,82 @@ private:
         ASSERT_EQUALS("[test.cpp:7]: (error) Memory leak: p\n", errout.str());
     }
 
+    void func16()
+    {
+        check("static void foo(char *str)\n"
+              "{\n"
+              "    delete str;\n"
+              "}\n"
+              "\n"
+              "static void f()\n"
+              "{\n"
+              "    char *p = new char;\n"
+              "    foo(p);\n"
+              "    char *q = new char[100];\n"
+              "    foo(q);\n"
+              "    char *r = new char[100];\n"
+              "    foo(r);\n"
+              "}\n", true);
+        ASSERT_EQUALS("[test.cpp:11] -> [test.cpp:3]: (error) Mismatching allocation and deallocation: str\n"
+                      "[test.cpp:13] -> [test.cpp:3]: (error) Mismatching allocation and deallocation: str\n",
+                      errout.str());
+    }
+
+
+
+    void summary()
+    {
+        const char code[] = "char *a()\n"
+                            "{\n"
+                            "    return new char[10];\n"
+                            "}\n"
+                            "void b(int n, char *p)\n"
+                            "{\n"
+                            "    delete [] p;\n"
+                            "}\n"
+                            "static void c(char *p)\n"
+                            "{\n"
+                            "    delete [] p;\n"
+                            "}\n";
+
+        Tokenizer tokenizer;
+        std::istringstream istr(code);
+        tokenizer.tokenize(istr, "test.cpp");
+        tokenizer.setVarId();
+        tokenizer.simplifyTokenList();
+        tokenizer.fillFunctionList();
+
+        Settings settings;
+        CheckMemoryLeakInFunction checkMemoryLeak(&tokenizer, &settings, this);
+        std::ostringstream summary;
+        checkMemoryLeak.summary(summary);
+        ASSERT_EQUALS("alloc a 4\n"
+                      "dealloc b 2 4\n", summary.str());
+
+        // Use the summary when another file is checked
+        std::istringstream summaryStream(summary.str());
+        checkMemoryLeak.readSummary(summaryStream, settings);
 
+        check("void f()\n"
+              "{\n"
+              "    char *p = a();\n"
+              "}\n", false, settings);
+        ASSERT_EQUALS("[test.cpp:4]: (error) Memory leak: p\n", errout.str());
+
+        check("void f()\n"
+              "{\n"
+              "    char *p = malloc(10);\n"
+              "    b(1, p);\n"
+              "}\n", false, settings);
+        ASSERT_EQUALS("[test.cpp:4]: (error) Mismatching allocation and deallocation: p\n", errout.str());
+
+        check("void f()\n"
+              "{\n"
+              "    char *p = malloc(10);\n"
+              "    c(p);\n"
+              "}\n", false, settings);
+        ASSERT_EQUALS("", errout.str());
+    }
 
     void allocfunc1()
     {
@@ -2271,6 +2349,17 @@ private:
               "    fcloseall();\n"
               "}\n");
         ASSERT_EQUALS("", errout.str());
+
+        // The variable is not allocated but it is released by fcloseall.
+        // All variables are checked when a function releases variables
+        // without naming them.
+        check("void f()\n"
+              "{\n"
+              "    char *p;\n"
+              "    fcloseall();\n"
+              "    p[0] = 0;\n"
+              "}\n");
+        ASSERT_EQUALS("[test.cpp:5]: (error) Dereferencing 'p' after it is deallocated / released\n", errout.str());
     }
 
     void open_function()
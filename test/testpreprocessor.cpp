@@ -63,6 +63,7 @@ private:
     {
         // Just read the code into a string. Perform simple cleanup of the code
         TEST_CASE(readCode);
+        TEST_CASE(readString);
 
         // The bug that started the whole work with the new preprocessor
         TEST_CASE(Bug2190219);
@@ -162,6 +163,17 @@ private:
         ASSERT_EQUALS("a \n#aa b \n", codestr);
     }
 
+    void readString()
+    {
+        const char code[] = " \t a //\n"
+                            "  #aa\t /* remove this */\tb  \r\n"
+                            "#define A 1 \\  \r\n"
+                            "+ 2\r";
+        std::istringstream istr(code);
+        ASSERT_EQUALS(Preprocessor::read(istr), Preprocessor::read(std::string(code)));
+        ASSERT_EQUALS("", Preprocessor::read(std::string("")));
+    }
+
 
     void Bug2190219()
     {
@@ -0,0 +1,104 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2009 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/
+ */
+
+
+#include "testsuite.h"
+#include "../src/reportwriter.h"
+
+#include <sstream>
+
+class TestReportWriter : public TestFixture
+{
+public:
+    TestReportWriter() : TestFixture("TestReportWriter")
+    { }
+
+private:
+    void run()
+    {
+        TEST_CASE(text);
+        TEST_CASE(xml);
+        TEST_CASE(buffering);
+    }
+
+    static ErrorLogger::ErrorMessage errmsg(const std::string &msg)
+    {
+        std::list<ErrorLogger::ErrorMessage::FileLocation> callStack;
+        ErrorLogger::ErrorMessage::FileLocation loc;
+        loc.file = "a.c";
+        loc.line = 10;
+        callStack.push_back(loc);
+        loc.line = 123;
+        callStack.push_back(loc);
+        return ErrorLogger::ErrorMessage(callStack, "error", msg, "id");
+    }
+
+    void text()
+    {
+        std::ostringstream ostr;
+        {
+            ReportWriter writer(ostr, false);
+            writer.writeHeader();
+            writer.write(errmsg("x"));
+            writer.writeFooter();
+        }
+        ASSERT_EQUALS("[a.c:10] -> [a.c:123]: (error) x\n", ostr.str());
+
+        // The messages are appended
+        std::string str("abc ");
+        errmsg("x").toText(str);
+        ASSERT_EQUALS("abc [a.c:10] -> [a.c:123]: (error) x", str);
+    }
+
+    void xml()
+    {
+        std::ostringstream ostr;
+        {
+            ReportWriter writer(ostr, true);
+            writer.writeHeader();
+            writer.write(errmsg("<a & \"b\">"));
+            writer.writeFooter();
+        }
+        ASSERT_EQUALS("<?xml version=\"1.0\"?>\n"
+                      "<results>\n"
+                      "<error file=\"a.c\" line=\"123\" id=\"id\" severity=\"error\" msg=\"&lt;a &amp; &quot;b&quot;&gt;\"/>\n"
+                      "</results>\n", ostr.str());
+    }
+
+    void buffering()
+    {
+        std::ostringstream ostr;
+        ReportWriter writer(ostr, false, 60);
+
+        // Nothing is written until the buffer is full
+        writer.write(errmsg("1"));
+        ASSERT_EQUALS("", ostr.str());
+
+        writer.write(errmsg("2"));
+        ASSERT_EQUALS("[a.c:10] -> [a.c:123]: (error) 1\n"
+                      "[a.c:10] -> [a.c:123]: (error) 2\n", ostr.str());
+
+        writer.write(errmsg("3"));
+        writer.flush();
+        ASSERT_EQUALS("[a.c:10] -> [a.c:123]: (error) 1\n"
+                      "[a.c:10] -> [a.c:123]: (error) 2\n"
+                      "[a.c:10] -> [a.c:123]: (error) 3\n", ostr.str());
+    }
+};
+
+REGISTER_TEST(TestReportWriter)
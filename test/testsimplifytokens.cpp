@@ -79,6 +79,9 @@ private:
         TEST_CASE(template10);
         TEST_CASE(template11);
         TEST_CASE(template12);
+        TEST_CASE(template13);  // repeated instantiation
+        TEST_CASE(template14);  // nested instantiation
+        TEST_CASE(template15);  // multiple arguments
 
         TEST_CASE(namespaces);
 
@@ -902,6 +905,83 @@ private:
         ASSERT_EQUALS(expected, sizeof_(code));
     }
 
+    void template13()
+    {
+        const char code[] = "template <classname T> class Fred { T a; };\n"
+                            "template <classname T> void Fred<T>::f() { }\n"
+                            "Fred<int> fred1;\n"
+                            "void g() { Fred<int> fred2; }\n"
+                            "Fred<int> fred3;";
+
+        // The expected result..
+        const std::string expected(" template < classname T > class Fred { T a ; } ;"
+                                   " template < classname T > void Fred < T > :: f ( ) { }"
+                                   " Fred<int> fred1 ;"
+                                   " void g ( ) { Fred<int> fred2 ; }"
+                                   " Fred<int> fred3 ;"
+                                   " class Fred<int> { int a ; }"
+                                   " Fred<int> :: f ( ) { }");
+        ASSERT_EQUALS(expected, sizeof_(code));
+    }
+
+    void template14()
+    {
+        {
+            const char code[] = "template <classname T> class Fred { Fred<T> *next; T a; };\n"
+                                "Fred<int> fred;";
+
+            // The expected result..
+            const std::string expected(" template < classname T > class Fred { Fred < T > * next ; T a ; } ;"
+                                       " Fred<int> fred ;"
+                                       " class Fred<int> { Fred<int> * next ; int a ; }");
+            ASSERT_EQUALS(expected, sizeof_(code));
+        }
+
+        {
+            const char code[] = "template <classname T> class B { A<T> b; };\n"
+                                "template <classname T> class A { T a; };\n"
+                                "B<int> b;\n"
+                                "A<char> a;";
+
+            // The A<int> in the expanded code is not expanded
+            const std::string actual(" template < classname T > class B { A < T > b ; } ;"
+                                     " template < classname T > class A { T a ; } ;"
+                                     " B<int> b ;"
+                                     " A<char> a ;"
+                                     " class B<int> { A < int > b ; }"
+                                     " class A<char> { char a ; }");
+            const std::string expected(" template < classname T > class B { A < T > b ; } ;"
+                                       " template < classname T > class A { T a ; } ;"
+                                       " B<int> b ;"
+                                       " A<char> a ;"
+                                       " class B<int> { A<int> b ; }"
+                                       " class A<char> { char a ; }"
+                                       " class A<int> { int a ; }");
+            ASSERT_EQUALS(actual, sizeof_(code));
+            TODO_ASSERT_EQUALS(expected, sizeof_(code));
+        }
+    }
+
+    void template15()
+    {
+        const char code[] = "template <classname T, int sz> class Fred { T data[sz]; };\n"
+                            "Fred<int,2> fred1;\n"
+                            "Fred<char,3> fred2;\n"
+                            "Fred<int,3> fred3;\n"
+                            "Fred<int,2> fred4;";
+
+        // The expected result..
+        const std::string expected(" template < classname T , int sz > class Fred { T data [ sz ] ; } ;"
+                                   " Fred<int,2> fred1 ;"
+                                   " Fred<char,3> fred2 ;"
+                                   " Fred<int,3> fred3 ;"
+                                   " Fred<int,2> fred4 ;"
+                                   " class Fred<int,2> { int data [ 2 ] ; }"
+                                   " class Fred<char,3> { char data [ 3 ] ; }"
+                                   " class Fred<int,3> { int data [ 3 ] ; }");
+        ASSERT_EQUALS(expected, sizeof_(code));
+    }
+
 
 
 
@@ -1200,6 +1280,36 @@ private:
             const char code[] = "a[10+10-10-10]";
             ASSERT_EQUALS("a [ 0 ]", tok(code));
         }
+
+        // integer chains
+        {
+            const char code[] = "a[2*3*4/2]";
+            ASSERT_EQUALS("a [ 12 ]", tok(code));
+        }
+        {
+            const char code[] = "a[0x10+010+1]";
+            ASSERT_EQUALS("a [ 25 ]", tok(code));
+        }
+        {
+            const char code[] = "x = 3 - 5 - 2 ;";
+            ASSERT_EQUALS("x = -4 ;", tok(code));
+        }
+        {
+            const char code[] = "a[7/2*2]";
+            ASSERT_EQUALS("a [ 6 ]", tok(code));
+        }
+        {
+            const char code[] = "x = 1 - 1 + 6 / 0 ;";
+            ASSERT_EQUALS("x = 0 + 6 / 0 ;", tok(code));
+        }
+        {
+            const char code[] = "x = 1 + 2 + 0.5 ;";
+            ASSERT_EQUALS("x = 3.5 ;", tok(code));
+        }
+        {
+            const char code[] = "x = 0.5 + 1 + 2 ;";
+            ASSERT_EQUALS("x = 3.5 ;", tok(code));
+        }
     }
 
 };
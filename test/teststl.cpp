@@ -76,8 +76,12 @@ private:
         errout.str("");
 
         // Check..
-        CheckStl checkStl;
-        checkStl.runSimplifiedChecks(&tokenizer, (const Settings *)0, this);
+        CheckStl checkStl(&tokenizer, 0, this);
+        checkStl.stlOutOfBounds();
+        checkStl.iterators();
+        checkStl.erase();
+        checkStl.pushback();
+        checkStl.stlBoundries();
     }
 
 
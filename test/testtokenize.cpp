@@ -138,6 +138,8 @@ private:
         TEST_CASE(volatile_variables);
         TEST_CASE(syntax_error);
 
+        TEST_CASE(links);
+
         TEST_CASE(removeKeywords);
 
         // unsigned i; => unsigned int i;
@@ -2319,6 +2321,15 @@ private:
             ASSERT_EQUALS("[test.cpp:1]: (error) Invalid number of character ((). Can't process file.\n", errout.str());
         }
 
+        {
+            errout.str("");
+            const char code[] = "void f() { a[0]]; }";
+            Tokenizer tokenizer(0, this);
+            std::istringstream istr(code);
+            ASSERT_EQUALS(false, tokenizer.tokenize(istr, "test.cpp"));
+            ASSERT_EQUALS("[test.cpp:1]: (error) Invalid number of character ([). Can't process file.\n", errout.str());
+        }
+
         {
             errout.str("");
             const char code[] = "namespace extract{\nB(weighted_moment)\n}\nusing extract::weighted_moment;\n";
@@ -2330,6 +2341,47 @@ private:
         }
     }
 
+    void links()
+    {
+        const char code[] = "void f(int a[10])\n"
+                            "{\n"
+                            "    if (x) { a[(1)] = 0; }\n"
+                            "}\n";
+
+        // The links are available right after tokenize..
+        Tokenizer tokenizer;
+        std::istringstream istr(code);
+        ASSERT_EQUALS(true, tokenizer.tokenize(istr, "test.cpp"));
+
+        const Token *tok = Token::findmatch(tokenizer.tokens(), "[");
+        ASSERT_EQUALS("]", tok->link()->str());
+        ASSERT_EQUALS(true, tok == tok->link()->link());
+        tok = Token::findmatch(tokenizer.tokens(), "{");
+        ASSERT_EQUALS(true, tok->link() == Tokenizer::findClosing(tok, "{", "}"));
+        ASSERT_EQUALS(true, tok->link()->next() == 0);
+
+        // ..and they are still valid after the simplifications
+        tokenizer.simplifyTokenList();
+        unsigned int count = 0;
+        for (tok = tokenizer.tokens(); tok; tok = tok->next())
+        {
+            if (Token::Match(tok, "(|[|{"))
+            {
+                ++count;
+                ASSERT_EQUALS(true, tok->link() && tok->link()->link() == tok);
+            }
+        }
+        ASSERT_EQUALS(6, count);
+
+        // A bracket that is changed into something else loses its link,
+        // so a link is never wrong during the simplifications
+        Token *paren = const_cast<Token *>(Token::findmatch(tokenizer.tokens(), "("));
+        Token *end = paren->link();
+        paren->str("!");
+        ASSERT_EQUALS(true, paren->link() == 0);
+        ASSERT_EQUALS(true, end->link() == 0);
+    }
+
     void removeKeywords()
     {
         const char code[] = "if (__builtin_expect(!!(x), 1));";
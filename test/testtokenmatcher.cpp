@@ -0,0 +1,157 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2009 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/
+ */
+
+
+#include "testsuite.h"
+#include "../src/tokenize.h"
+#include "../src/token.h"
+#include "../src/tokenmatcher.h"
+
+#include <sstream>
+
+extern std::ostringstream errout;
+
+class TestTokenMatcher : public TestFixture, public TokenMatcher::Listener
+{
+public:
+    TestTokenMatcher() : TestFixture("TestTokenMatcher")
+    { }
+
+private:
+    /** The matches that were found: "linenr:id " */
+    std::ostringstream matches;
+
+    void patternMatch(const Token *tok, unsigned int id)
+    {
+        matches << tok->linenr() << ":" << id << " ";
+    }
+
+    void run()
+    {
+        TEST_CASE(literal);
+        TEST_CASE(alternatives);
+        TEST_CASE(wildcards);
+        TEST_CASE(wildcardAlternatives);
+        TEST_CASE(varid);
+    }
+
+    std::string match(const char code[], TokenMatcher &matcher)
+    {
+        Tokenizer tokenizer;
+        std::istringstream istr(code);
+        tokenizer.tokenize(istr, "test.cpp");
+        tokenizer.setVarId();
+
+        matches.str("");
+        matcher.run(tokenizer.tokens());
+        return matches.str();
+    }
+
+    void literal()
+    {
+        TokenMatcher matcher;
+        matcher.addPattern("gets (", this, 1);
+        matcher.addPattern("scanf (", this, 2);
+        matcher.addPattern("/ 0", this, 3);
+        ASSERT_EQUALS(3, matcher.size());
+
+        ASSERT_EQUALS("2:1 3:2 4:3 ", match("void f() {\n"
+                                            "    gets(s);\n"
+                                            "    scanf(s);\n"
+                                            "    x = a / 0;\n"
+                                            "    gets;\n"
+                                            "}\n", matcher));
+    }
+
+    void alternatives()
+    {
+        TokenMatcher matcher;
+        matcher.addPattern("strcpy|strcat (", this, 1);
+        matcher.addPattern("[;{}] return", this, 2);
+        matcher.addPattern("free|delete %var%", this, 3);
+
+        ASSERT_EQUALS("2:1 3:1 4:3 4:2 ", match("f() {\n"
+                                                "    strcpy(a, b);\n"
+                                                "    strcat(a, b);\n"
+                                                "    delete p;\n"
+                                                "    return\n"
+                                                "}\n", matcher));
+    }
+
+    void wildcards()
+    {
+        TokenMatcher matcher;
+        matcher.addPattern("%var% =", this, 1);
+        matcher.addPattern("%num% ;", this, 2);
+        matcher.addPattern("!!else {", this, 3);
+
+        // Note: "!!else" is always skipped at the first token
+        ASSERT_EQUALS("1:3 2:1 2:2 3:3 ", match("{\n"
+                                                "    a = 10;\n"
+                                                "    if (x) {}\n"
+                                                "    else {}\n"
+                                                "}\n", matcher));
+    }
+
+    /** The matches that Token::Match() finds when it is called at every token */
+    std::string matchAll(const char code[], const char pattern[])
+    {
+        Tokenizer tokenizer;
+        std::istringstream istr(code);
+        tokenizer.tokenize(istr, "test.cpp");
+
+        std::ostringstream ostr;
+        for (const Token *tok = tokenizer.tokens(); tok; tok = tok->next())
+        {
+            if (Token::Match(tok, pattern))
+                ostr << tok->linenr() << ":1 ";
+        }
+        return ostr.str();
+    }
+
+    void wildcardAlternatives()
+    {
+        // An alternative that starts with '%' is not a literal string, the
+        // pattern must be tested at every token
+        const char code[] = "void f() {\n"
+                            "    if (x) { }\n"
+                            "    g(x);\n"
+                            "}\n";
+        const char pattern[] = "if|%var% (";
+
+        TokenMatcher matcher;
+        matcher.addPattern(pattern, this, 1);
+        const std::string expected(matchAll(code, pattern));
+        ASSERT_EQUALS(false, expected.empty());
+        ASSERT_EQUALS(expected, match(code, matcher));
+    }
+
+    void varid()
+    {
+        TokenMatcher matcher;
+        matcher.addPattern("%varid% = 0", this, 1, 2);
+
+        ASSERT_EQUALS("4:1 ", match("void f() {\n"
+                                    "    int a; int b;\n"
+                                    "    a = 0;\n"
+                                    "    b = 0;\n"
+                                    "}\n", matcher));
+    }
+};
+
+REGISTER_TEST(TestTokenMatcher)
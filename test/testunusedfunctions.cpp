@@ -42,6 +42,7 @@ private:
         TEST_CASE(else1);
         TEST_CASE(functionpointer);
         TEST_CASE(template1);
+        TEST_CASE(summary);
     }
 
     void check(const char code[])
@@ -132,6 +133,36 @@ private:
               "}\n");
         ASSERT_EQUALS("", errout.str());
     }
+
+    void summary()
+    {
+        // Parse the files separately..
+        Tokenizer tokenizer1;
+        std::istringstream istr1("void f1() { }\n"
+                                 "void f2() { f3(); }\n");
+        tokenizer1.tokenize(istr1, "file1.cpp");
+        CheckUnusedFunctions check1;
+        check1.parseTokens(tokenizer1);
+
+        Tokenizer tokenizer2;
+        std::istringstream istr2("void f3() { }\n"
+                                 "int main() { f2(); }\n");
+        tokenizer2.tokenize(istr2, "file2.cpp");
+        CheckUnusedFunctions check2;
+        check2.parseTokens(tokenizer2);
+
+        // ..and merge the summaries
+        std::ostringstream summary;
+        check1.writeSummary(summary);
+        check2.writeSummary(summary);
+
+        errout.str("");
+        CheckUnusedFunctions checkUnusedFunctions(this);
+        std::istringstream istr(summary.str());
+        checkUnusedFunctions.readSummary(istr);
+        ASSERT_EQUALS(1, checkUnusedFunctions.check());
+        ASSERT_EQUALS("[file1.cpp:1]: (style) The function 'f1' is never used\n", errout.str());
+    }
 };
 
 REGISTER_TEST(TestUnusedFunctions)
@@ -99,10 +99,10 @@ int main()
 
     fout << "\n###### Targets\n\n";
     fout << "cppcheck:\t$(OBJECTS)\n";
-    fout << "\t$(CXX) $(CXXFLAGS) -o cppcheck $(OBJECTS) $(LDFLAGS)\n\n";
+    fout << "\t$(CXX) $(CXXFLAGS) -o cppcheck $(OBJECTS) $(LDFLAGS) -lpthread\n\n";
     fout << "all:\tcppcheck\ttestrunner\ttools\n\n";
     fout << "testrunner:\t$(TESTOBJ)\n";
-    fout << "\t$(CXX) $(CXXFLAGS) -o testrunner $(TESTOBJ) $(LDFLAGS)\n\n";
+    fout << "\t$(CXX) $(CXXFLAGS) -o testrunner $(TESTOBJ) $(LDFLAGS) -lpthread\n\n";
     fout << "test:\tall\n";
     fout << "\t./testrunner\n\n";
     fout << "tools:\ttools/dmake\n\n";